@@ -0,0 +1,341 @@
+/**
+ * If not stated otherwise in this file or this component's LICENSE
+ * file the following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "FakeGDialService.h"
+#include "gdialservice.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+    struct FakeState
+    {
+        std::mutex mutex;
+        gdialService* instance = nullptr;
+        GDialNotifier* observer = nullptr;
+        std::vector<FakeGDial::CallRecord> calls;
+        std::string protocolVersion = "2.2.1";
+        bool failGetInstance = false;
+        std::chrono::microseconds latency{0};
+
+        std::list<std::thread> streams;
+        std::atomic<bool> stopping{false};
+        std::atomic<uint64_t> emitted{0};
+        std::condition_variable streamsStopped;
+
+        //Streams destroyInstance() left running are joined at exit at the latest
+        ~FakeState()
+        {
+            stopping = true;
+            streamsStopped.notify_all();
+            for (std::thread& stream : streams)
+            {
+                if (stream.joinable())
+                {
+                    stream.join();
+                }
+            }
+        }
+    };
+
+    FakeState& state()
+    {
+        static FakeState fakeState;
+        return fakeState;
+    }
+
+    void recordCall(const char* method, const std::string& arguments)
+    {
+        FakeState& fake = state();
+        std::chrono::microseconds latency;
+        {
+            std::lock_guard<std::mutex> lock(fake.mutex);
+            fake.calls.push_back({ std::chrono::steady_clock::now(), method, arguments });
+            latency = fake.latency;
+        }
+        if (latency.count() > 0)
+        {
+            std::this_thread::sleep_for(latency);
+        }
+    }
+
+    GDialNotifier* currentObserver()
+    {
+        FakeState& fake = state();
+        std::lock_guard<std::mutex> lock(fake.mutex);
+        return fake.observer;
+    }
+
+    void emitCallback(const FakeGDial::CallbackStream& stream, const std::string& payload)
+    {
+        GDialNotifier* observer = currentObserver();
+        if (nullptr == observer)
+        {
+            return;
+        }
+        switch (stream.kind)
+        {
+            case FakeGDial::CallbackStream::LAUNCH:
+                observer->onApplicationLaunchRequest(stream.appName, payload);
+                break;
+            case FakeGDial::CallbackStream::LAUNCH_WITH_PARAMS:
+                observer->onApplicationLaunchRequestWithLaunchParam(stream.appName, payload, "source_type=12", "");
+                break;
+            case FakeGDial::CallbackStream::STOP:
+                observer->onApplicationStopRequest(stream.appName, stream.appId);
+                break;
+            case FakeGDial::CallbackStream::HIDE:
+                observer->onApplicationHideRequest(stream.appName, stream.appId);
+                break;
+            case FakeGDial::CallbackStream::RESUME:
+                observer->onApplicationResumeRequest(stream.appName, stream.appId);
+                break;
+            case FakeGDial::CallbackStream::STATE:
+                observer->onApplicationStateRequest(stream.appName, stream.appId);
+                break;
+        }
+        state().emitted.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void runStream(FakeGDial::CallbackStream stream)
+    {
+        FakeState& fake = state();
+        const std::string payload(stream.payloadSize, 'x');
+        const std::chrono::nanoseconds period = (0 == stream.ratePerSecond) ?
+            std::chrono::nanoseconds(0) : std::chrono::nanoseconds(1000000000ULL / stream.ratePerSecond);
+        auto next = std::chrono::steady_clock::now();
+
+        for (uint64_t sent = 0; ((0 == stream.count) || (sent < stream.count)) && !fake.stopping; ++sent)
+        {
+            emitCallback(stream, payload);
+            if (0 != period.count())
+            {
+                //Fixed schedule, so a slow observer shows up as lag instead of a lower rate
+                next += period;
+                std::unique_lock<std::mutex> lock(fake.mutex);
+                fake.streamsStopped.wait_until(lock, next, [&fake]() { return fake.stopping.load(); });
+            }
+        }
+    }
+
+} // namespace
+
+namespace FakeGDial {
+
+    bool startStream(const CallbackStream& stream)
+    {
+        FakeState& fake = state();
+        std::list<std::thread> stopped;
+        {
+            std::lock_guard<std::mutex> lock(fake.mutex);
+            if (fake.stopping)
+            {
+                stopped.swap(fake.streams);
+            }
+        }
+        //Streams told to stop by destroyInstance() would run on once the flag is cleared, they are gone first
+        for (std::thread& worker : stopped)
+        {
+            worker.join();
+        }
+
+        std::lock_guard<std::mutex> lock(fake.mutex);
+        if (nullptr == fake.observer)
+        {
+            return false;
+        }
+        fake.stopping = false;
+        fake.streams.emplace_back(runStream, stream);
+        return true;
+    }
+
+    void waitForStreams(void)
+    {
+        FakeState& fake = state();
+        std::list<std::thread> streams;
+        {
+            std::lock_guard<std::mutex> lock(fake.mutex);
+            streams.swap(fake.streams);
+        }
+        for (std::thread& stream : streams)
+        {
+            stream.join();
+        }
+    }
+
+    void stopStreams(void)
+    {
+        FakeState& fake = state();
+        {
+            std::lock_guard<std::mutex> lock(fake.mutex);
+            fake.stopping = true;
+        }
+        fake.streamsStopped.notify_all();
+        waitForStreams();
+    }
+
+    uint64_t getCallbacksEmitted(void)
+    {
+        return state().emitted.load(std::memory_order_relaxed);
+    }
+
+    std::vector<CallRecord> getCallRecords(void)
+    {
+        FakeState& fake = state();
+        std::lock_guard<std::mutex> lock(fake.mutex);
+        return fake.calls;
+    }
+
+    void clearCallRecords(void)
+    {
+        FakeState& fake = state();
+        std::lock_guard<std::mutex> lock(fake.mutex);
+        fake.calls.clear();
+        fake.emitted = 0;
+    }
+
+    void setProtocolVersion(const std::string& version)
+    {
+        FakeState& fake = state();
+        std::lock_guard<std::mutex> lock(fake.mutex);
+        fake.protocolVersion = version;
+    }
+
+    void setFailGetInstance(bool fail)
+    {
+        FakeState& fake = state();
+        std::lock_guard<std::mutex> lock(fake.mutex);
+        fake.failGetInstance = fail;
+    }
+
+    void setCallLatency(std::chrono::microseconds latency)
+    {
+        FakeState& fake = state();
+        std::lock_guard<std::mutex> lock(fake.mutex);
+        fake.latency = latency;
+    }
+
+} // namespace FakeGDial
+
+gdialService* gdialService::getInstance(GDialNotifier* observer, const std::vector<std::string>& gdial_args, const std::string& actualprocessName)
+{
+    std::ostringstream arguments;
+    arguments << actualprocessName;
+    for (const std::string& argument : gdial_args)
+    {
+        arguments << ' ' << argument;
+    }
+    recordCall("getInstance", arguments.str());
+
+    FakeState& fake = state();
+    std::lock_guard<std::mutex> lock(fake.mutex);
+    if (fake.failGetInstance)
+    {
+        return nullptr;
+    }
+    if (nullptr == fake.instance)
+    {
+        fake.instance = new gdialService();
+        fake.instance->m_observer = observer;
+        fake.observer = observer;
+    }
+    return fake.instance;
+}
+
+void gdialService::destroyInstance()
+{
+    recordCall("destroyInstance", "");
+
+    //XCastManager calls this holding its gdial lock, which a callback in flight may need;
+    //the streams are only told to stop here and stopStreams() joins them
+    FakeState& fake = state();
+    {
+        std::lock_guard<std::mutex> lock(fake.mutex);
+        fake.stopping = true;
+        delete fake.instance;
+        fake.instance = nullptr;
+        fake.observer = nullptr;
+    }
+    fake.streamsStopped.notify_all();
+}
+
+GDIAL_SERVICE_ERROR_CODES gdialService::ApplicationStateChanged(std::string applicationName, std::string appState, std::string applicationId, std::string error)
+{
+    recordCall("ApplicationStateChanged", applicationName + " " + appState + " " + applicationId + " " + error);
+    return GDIAL_SERVICE_ERROR_NONE;
+}
+
+GDIAL_SERVICE_ERROR_CODES gdialService::ActivationChanged(std::string activation, std::string friendlyname)
+{
+    recordCall("ActivationChanged", activation + " " + friendlyname);
+    return GDIAL_SERVICE_ERROR_NONE;
+}
+
+GDIAL_SERVICE_ERROR_CODES gdialService::FriendlyNameChanged(std::string friendlyname)
+{
+    recordCall("FriendlyNameChanged", friendlyname);
+    return GDIAL_SERVICE_ERROR_NONE;
+}
+
+std::string gdialService::getProtocolVersion(void)
+{
+    recordCall("getProtocolVersion", "");
+    FakeState& fake = state();
+    std::lock_guard<std::mutex> lock(fake.mutex);
+    return fake.protocolVersion;
+}
+
+GDIAL_SERVICE_ERROR_CODES gdialService::RegisterApplications(RegisterAppEntryList* appConfigList)
+{
+    if (nullptr == appConfigList)
+    {
+        recordCall("RegisterApplications", "");
+        return GDIAL_SERVICE_INVALID_PARAM_ERROR;
+    }
+    std::ostringstream arguments;
+    for (RegisterAppEntry* appEntry : appConfigList->getValues())
+    {
+        arguments << appEntry->Names << ':' << appEntry->prefixes << ' ';
+    }
+    //Ownership was handed over like with the real server
+    delete appConfigList;
+    recordCall("RegisterApplications", arguments.str());
+    return GDIAL_SERVICE_ERROR_NONE;
+}
+
+void gdialService::setNetworkStandbyMode(bool nwStandbymode)
+{
+    recordCall("setNetworkStandbyMode", nwStandbymode ? "true" : "false");
+}
+
+void gdialService::setManufacturerName(std::string manufacturer)
+{
+    recordCall("setManufacturerName", manufacturer);
+}
+
+void gdialService::setModelName(std::string model)
+{
+    recordCall("setModelName", model);
+}
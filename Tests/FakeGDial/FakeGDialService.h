@@ -0,0 +1,78 @@
+/**
+ * If not stated otherwise in this file or this component's LICENSE
+ * file the following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * In-process stand-in for xdialserver. Linking libFakeGDialService instead of gdial-server
+ * provides the gdialservice.h API without a DIAL server: every call into gdialService is
+ * recorded with a timestamp, and DIAL requests are injected as configurable callback streams
+ * into the GDialNotifier that called getInstance().
+ */
+namespace FakeGDial {
+
+    struct CallRecord
+    {
+        std::chrono::steady_clock::time_point timestamp;
+        std::string method;
+        std::string arguments;
+    };
+
+    struct CallbackStream
+    {
+        enum Kind
+        {
+            LAUNCH,
+            LAUNCH_WITH_PARAMS,
+            STOP,
+            HIDE,
+            RESUME,
+            STATE
+        };
+        Kind kind = LAUNCH;
+        std::string appName;
+        std::string appId;
+        uint32_t ratePerSecond = 1;  // 0 emits back to back
+        size_t payloadSize = 0;      // bytes of launch payload
+        uint64_t count = 0;          // 0 runs until stopStreams()
+    };
+
+    // Runs the stream on its own thread against the current observer
+    bool startStream(const CallbackStream& stream);
+    // destroyInstance() detaches the observer without joining; call this outside any lock the
+    // observer takes, before the observer goes away, as a callback may still be in flight
+    void stopStreams(void);
+    // Joins every started stream; a stream with count 0 only ends through stopStreams()
+    void waitForStreams(void);
+    uint64_t getCallbacksEmitted(void);
+
+    std::vector<CallRecord> getCallRecords(void);
+    void clearCallRecords(void);
+
+    // Behaviour of the fake gdial side
+    void setProtocolVersion(const std::string& version);
+    void setFailGetInstance(bool fail);
+    void setCallLatency(std::chrono::microseconds latency);
+
+} // namespace FakeGDial
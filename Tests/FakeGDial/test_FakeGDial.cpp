@@ -0,0 +1,114 @@
+/**
+ * If not stated otherwise in this file or this component's LICENSE
+ * file the following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include <gtest/gtest.h>
+
+#include "FakeGDialService.h"
+#include "gdialservice.h"
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+    // Takes the same lock around every callback that the test holds around destroyInstance(),
+    // like XCastManager does with its gdial lock
+    class LockingObserver : public GDialNotifier
+    {
+    public:
+        explicit LockingObserver(std::mutex& lock) : m_lock(lock) {}
+
+        void onApplicationLaunchRequest(std::string appName, std::string parameter) override
+        {
+            ++entered;
+            std::lock_guard<std::mutex> lock(m_lock);
+            ++launches;
+        }
+        void onApplicationLaunchRequestWithLaunchParam(std::string appName, std::string strPayLoad, std::string strQuery, std::string strAddDataUrl) override {}
+        void onApplicationStopRequest(std::string appName, std::string appID) override {}
+        void onApplicationHideRequest(std::string appName, std::string appID) override {}
+        void onApplicationResumeRequest(std::string appName, std::string appID) override {}
+        void onApplicationStateRequest(std::string appName, std::string appID) override {}
+        void updatePowerState(std::string powerState) override {}
+
+        std::atomic<uint64_t> entered{0};
+        std::atomic<uint64_t> launches{0};
+
+    private:
+        std::mutex& m_lock;
+    };
+
+} // namespace
+
+TEST(FakeGDialTest, recordsCalls)
+{
+    std::mutex observerLock;
+    LockingObserver observer(observerLock);
+    FakeGDial::clearCallRecords();
+
+    gdialService* instance = gdialService::getInstance(&observer, { "-I", "eth0" }, "FakeGDialTest");
+    ASSERT_NE(nullptr, instance);
+    EXPECT_EQ(std::string("2.2.1"), instance->getProtocolVersion());
+    EXPECT_EQ(GDIAL_SERVICE_ERROR_NONE, instance->ActivationChanged("true", "Living Room"));
+    gdialService::destroyInstance();
+
+    std::vector<FakeGDial::CallRecord> calls = FakeGDial::getCallRecords();
+    ASSERT_EQ(4u, calls.size());
+    EXPECT_EQ(std::string("getInstance"), calls[0].method);
+    EXPECT_EQ(std::string("FakeGDialTest -I eth0"), calls[0].arguments);
+    EXPECT_EQ(std::string("getProtocolVersion"), calls[1].method);
+    EXPECT_EQ(std::string("ActivationChanged"), calls[2].method);
+    EXPECT_EQ(std::string("true Living Room"), calls[2].arguments);
+    EXPECT_EQ(std::string("destroyInstance"), calls[3].method);
+}
+
+TEST(FakeGDialTest, destroyInstanceUnderObserverLock)
+{
+    std::mutex observerLock;
+    LockingObserver observer(observerLock);
+    FakeGDial::CallbackStream stream;
+    stream.kind = FakeGDial::CallbackStream::LAUNCH;
+    stream.appName = "Netflix";
+    stream.ratePerSecond = 0;
+
+    ASSERT_NE(nullptr, gdialService::getInstance(&observer, { "-I", "eth0" }, "FakeGDialTest"));
+    std::future<void> destroyed;
+    {
+        // A stream blocked on the lock must not keep destroyInstance() from returning
+        std::lock_guard<std::mutex> lock(observerLock);
+        ASSERT_TRUE(FakeGDial::startStream(stream));
+        while (0 == observer.entered)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        destroyed = std::async(std::launch::async, []() { gdialService::destroyInstance(); });
+        EXPECT_EQ(std::future_status::ready, destroyed.wait_for(std::chrono::seconds(2)));
+        EXPECT_EQ(0u, observer.launches.load());
+    }
+    destroyed.wait();
+
+    // Joined outside the lock; nothing reaches the observer afterwards
+    FakeGDial::stopStreams();
+    const uint64_t launches = observer.launches;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(launches, observer.launches.load());
+    EXPECT_FALSE(FakeGDial::startStream(stream));
+}
@@ -119,9 +119,104 @@ struct GenerateUUIDv5FromSerialNumberTag {
     friend type get(GenerateUUIDv5FromSerialNumberTag);
 };
 
+struct GetIdentityCacheFileTag {
+    typedef std::string (XCastManager::*type)(WPEFramework::PluginHost::IShell*);
+    friend type get(GetIdentityCacheFileTag);
+};
+
+struct GetIdentitySourcesStampTag {
+    typedef std::string (XCastManager::*type)(void);
+    friend type get(GetIdentitySourcesStampTag);
+};
+
+struct LoadIdentityCacheTag {
+    typedef bool (XCastManager::*type)(const std::string&, const std::string&, std::string&);
+    friend type get(LoadIdentityCacheTag);
+};
+
+struct SaveIdentityCacheTag {
+    typedef void (XCastManager::*type)(const std::string&, const std::string&, const std::string&, const std::string&);
+    friend type get(SaveIdentityCacheTag);
+};
+
+struct EnvGetValueTag {
+    typedef bool (XCastManager::*type)(const char*, std::string&);
+    friend type get(EnvGetValueTag);
+};
+
+struct SetDevicePropertiesFileTag {
+    typedef void (XCastManager::*type)(const std::string&);
+    friend type get(SetDevicePropertiesFileTag);
+};
+
 // Explicit instantiation to create the accessor
 template struct PrivateMethodAccessor<GetSerialNumberFromDeviceInfoTag, &XCastManager::getSerialNumberFromDeviceInfo>;
 template struct PrivateMethodAccessor<GenerateUUIDv5FromSerialNumberTag, &XCastManager::generateUUIDv5FromSerialNumber>;
+template struct PrivateMethodAccessor<GetIdentityCacheFileTag, &XCastManager::getIdentityCacheFile>;
+template struct PrivateMethodAccessor<GetIdentitySourcesStampTag, &XCastManager::getIdentitySourcesStamp>;
+template struct PrivateMethodAccessor<LoadIdentityCacheTag, &XCastManager::loadIdentityCache>;
+template struct PrivateMethodAccessor<SaveIdentityCacheTag, &XCastManager::saveIdentityCache>;
+template struct PrivateMethodAccessor<EnvGetValueTag, &XCastManager::envGetValue>;
+template struct PrivateMethodAccessor<SetDevicePropertiesFileTag, &XCastManager::setDevicePropertiesFile>;
+
+struct LoadInterfaceTypeRulesTag {
+    typedef void (Plugin::XCastImplementation::*type)(PluginHost::IShell*);
+    friend type get(LoadInterfaceTypeRulesTag);
+};
+
+struct GetInterfaceNameToTypeTag {
+    typedef string (Plugin::XCastImplementation::*type)(const string&);
+    friend type get(GetInterfaceNameToTypeTag);
+};
+
+struct WarmRestartGDialServiceTag {
+    typedef void (Plugin::XCastImplementation::*type)(void);
+    friend type get(WarmRestartGDialServiceTag);
+};
+
+template struct PrivateMethodAccessor<LoadInterfaceTypeRulesTag, &Plugin::XCastImplementation::loadInterfaceTypeRules>;
+template struct PrivateMethodAccessor<GetInterfaceNameToTypeTag, &Plugin::XCastImplementation::getInterfaceNameToType>;
+template struct PrivateMethodAccessor<WarmRestartGDialServiceTag, &Plugin::XCastImplementation::warmRestartGDialService>;
+
+// applyRFCInputs takes the private RFCInputs type, so its accessor deduces the method type instead
+template<typename Tag, typename T, T M>
+struct DeducedPrivateMethodAccessor {
+    friend auto get(Tag) {
+        return M;
+    }
+};
+
+struct ApplyRFCInputsTag {
+    friend auto get(ApplyRFCInputsTag);
+};
+
+template struct DeducedPrivateMethodAccessor<ApplyRFCInputsTag, decltype(&XCastManager::applyRFCInputs), &XCastManager::applyRFCInputs>;
+
+// onGDialServiceConnected takes the private GDialConnectReason, deduced the same way
+struct OnGDialServiceConnectedTag {
+    friend auto get(OnGDialServiceConnectedTag);
+};
+
+template struct DeducedPrivateMethodAccessor<OnGDialServiceConnectedTag, decltype(&Plugin::XCastImplementation::onGDialServiceConnected), &Plugin::XCastImplementation::onGDialServiceConnected>;
+
+// connectToGDialService takes the same private GDialConnectReason
+struct ConnectToGDialServiceTag {
+    friend auto get(ConnectToGDialServiceTag);
+};
+
+template struct DeducedPrivateMethodAccessor<ConnectToGDialServiceTag, decltype(&Plugin::XCastImplementation::connectToGDialService), &Plugin::XCastImplementation::connectToGDialService>;
+
+template<typename T> struct GDialConnectReasonOf;
+template<typename C, typename Reason>
+struct GDialConnectReasonOf<void (C::*)(bool, const string&, Reason, std::chrono::steady_clock::time_point)> {
+    typedef Reason type;
+};
+
+template<typename T> struct RFCInputsOf;
+template<typename C, typename Inputs>
+struct RFCInputsOf<bool (C::*)(const Inputs&, const Inputs&)> {
+    typedef Inputs type;
+};
 
 // Test wrapper class that uses the accessor
 class XCastManagerTestWrapper {
@@ -144,6 +239,45 @@ public:
         auto methodPtr = get(GenerateUUIDv5FromSerialNumberTag{});
         return (m_instance->*methodPtr)(serialNumber);
     }
+
+    std::string testGetIdentityCacheFile(WPEFramework::PluginHost::IShell* pluginService) {
+        auto methodPtr = get(GetIdentityCacheFileTag{});
+        return (m_instance->*methodPtr)(pluginService);
+    }
+
+    std::string testGetIdentitySourcesStamp() {
+        auto methodPtr = get(GetIdentitySourcesStampTag{});
+        return (m_instance->*methodPtr)();
+    }
+
+    bool testLoadIdentityCache(const std::string& cacheFile, const std::string& stamp, std::string& receiverId) {
+        auto methodPtr = get(LoadIdentityCacheTag{});
+        return (m_instance->*methodPtr)(cacheFile, stamp, receiverId);
+    }
+
+    void testSaveIdentityCache(const std::string& cacheFile, const std::string& receiverId, const std::string& source, const std::string& stamp) {
+        auto methodPtr = get(SaveIdentityCacheTag{});
+        (m_instance->*methodPtr)(cacheFile, receiverId, source, stamp);
+    }
+
+    bool testEnvGetValue(const char* key, std::string& value) {
+        auto methodPtr = get(EnvGetValueTag{});
+        return (m_instance->*methodPtr)(key, value);
+    }
+
+    void testSetDevicePropertiesFile(const std::string& fileName) {
+        auto methodPtr = get(SetDevicePropertiesFileTag{});
+        (m_instance->*methodPtr)(fileName);
+    }
+
+    // Publishes appList as gdial's default app list, as an RFC change would
+    bool testApplyDefaultAppList(const std::string& appList) {
+        auto methodPtr = get(ApplyRFCInputsTag{});
+        RFCInputsOf<decltype(methodPtr)>::type previous, current;
+        current.hasAppList = true;
+        current.appList = appList;
+        return (m_instance->*methodPtr)(previous, current);
+    }
 };
 
 class XCastTest : public ::testing::Test {
@@ -281,6 +415,8 @@ protected:
                 }));
 
         EXPECT_EQ(string(""), plugin->Initialize(mServiceMock));
+        // gdial is brought up in the background after activation
+        EXPECT_TRUE(XCastManager::getInstance()->waitForInitialize(5000));
         TEST_LOG("createResources - All done!");
         status = Core::ERROR_NONE;
 
@@ -380,6 +516,9 @@ TEST_F(XCastTest, RegisteredMethods)
     EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Exists(_T("getProtocolVersion")));
     EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Exists(_T("unregisterApplications")));
     EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Exists(_T("getProtocolVersion")));
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Exists(_T("getRegisteredApplications")));
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Exists(_T("updateApplications")));
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Exists(_T("getGDialCallStats")));
 
     if (Core::ERROR_NONE == status)
     {
@@ -621,34 +760,874 @@ TEST_F(XCastTest, unRegisterAllApplications)
                 return GDIAL_SERVICE_ERROR_NONE;
             }));
 
+    // Registry changes no longer toggle the cast service, only the timer re-enables it after reconnect
     EXPECT_CALL(*p_gdialserviceImplMock, ActivationChanged(::testing::_,::testing::_))
-        .Times(3)
+        .Times(1)
         .WillOnce(::testing::Invoke(
             [&](std::string activation, std::string friendlyname) {
+                wg.Done();
+                return GDIAL_SERVICE_ERROR_NONE;
+            }));
+
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("registerApplications"), _T("{\"applications\": [{\"name\": \"Youtube\",\"prefix\": \"myYouTube\",\"cors\": \".youtube.com\",\"query\": \"source_type=12\",\"payload\": \"youtube_payload\",\"allowStop\": 1 },{\"name\": \"Netflix\",\"prefix\": \"myNetflix\",\"cors\": \".netflix.com\",\"query\": \"source_type=12\",\"payload\": \"netflix_payload\",\"allowStop\": 0}]}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("unregisterApplications"), _T("{\"applications\": [\"Youtube\"]}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+
+    // Added to trigger registerApplication handling based on timer, the bound interface moving address forces a rebind
+    ASSERT_NE(_networkManagerNotification, nullptr);
+    _networkManagerNotification->onIPAddressChange(XCastManager::getInstance()->getGDialInterface(), "IPv4", "192.168.5.100", Exchange::INetworkManager::IP_ACQUIRED);
+    usleep(50);
+
+    wg.Wait();
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, primaryInterfaceChangeKeepsBinding)
+{
+    Core::hresult status = createResources();
+
+    // The binding follows gdial's own -I, not the NM primary interface
+    const string gdialInterface = XCastManager::getInstance()->getGDialInterface();
+    ASSERT_FALSE(gdialInterface.empty());
+    const string otherInterface = ("eth0" == gdialInterface) ? "wlan0" : "eth0";
+
+    // gdial's interface still holds its address, gdial keeps advertising on it instead of restarting
+    ASSERT_NE(_networkManagerNotification, nullptr);
+    _networkManagerNotification->onActiveInterfaceChange("eth0", "wlan0");
+    EXPECT_EQ(1, XCastManager::getInstance()->isGDialStarted());
+
+    // An interface gdial does not advertise on going away leaves it running
+    _networkManagerNotification->onIPAddressChange(otherInterface, "IPv4", "", Exchange::INetworkManager::IP_LOST);
+    EXPECT_EQ(1, XCastManager::getInstance()->isGDialStarted());
+
+    // Losing the bound address fails over to the primary interface
+    _networkManagerNotification->onIPAddressChange(gdialInterface, "IPv4", "", Exchange::INetworkManager::IP_LOST);
+    EXPECT_EQ(0, XCastManager::getInstance()->isGDialStarted());
+    EXPECT_TRUE(XCastManager::getInstance()->getGDialInterface().empty());
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, interfaceTypeRulesConfigured)
+{
+    Core::hresult status = createResources();
+    auto loadRules = get(LoadInterfaceTypeRulesTag{});
+    auto interfaceType = get(GetInterfaceNameToTypeTag{});
+
+    // Malformed entries are skipped, the rest apply in order ahead of the built-in ones
+    ON_CALL(*mServiceMock, ConfigLine())
+        .WillByDefault(::testing::Return(string("{\"interfacetypes\":\" eth*:LAN , moca*:MOCA,bogus,:WIFI,wlan1:,,wlan*:WLAN \"}")));
+    ((*xcastImpl).*loadRules)(mServiceMock);
+
+    EXPECT_EQ(string("LAN"), ((*xcastImpl).*interfaceType)("eth0"));
+    EXPECT_EQ(string("LAN"), ((*xcastImpl).*interfaceType)("eth1"));
+    EXPECT_EQ(string("MOCA"), ((*xcastImpl).*interfaceType)("moca0"));
+    EXPECT_EQ(string("WLAN"), ((*xcastImpl).*interfaceType)("wlan0"));
+    EXPECT_EQ(string("WLAN"), ((*xcastImpl).*interfaceType)("wlan1"));
+    EXPECT_EQ(string(""), ((*xcastImpl).*interfaceType)("bogus"));
+    EXPECT_EQ(string(""), ((*xcastImpl).*interfaceType)("lo"));
+
+    // Back to the built-in rules for the following tests
+    ON_CALL(*mServiceMock, ConfigLine())
+        .WillByDefault(::testing::Return(string("{}")));
+    ((*xcastImpl).*loadRules)(mServiceMock);
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, interfaceTypeRulesFallback)
+{
+    Core::hresult status = createResources();
+    auto loadRules = get(LoadInterfaceTypeRulesTag{});
+    auto interfaceType = get(GetInterfaceNameToTypeTag{});
+    string deviceRules;
+
+    ON_CALL(*mServiceMock, ConfigLine())
+        .WillByDefault(::testing::Return(string("{}")));
+    ((*xcastImpl).*loadRules)(mServiceMock);
+
+    // Only the built-in names unless device.properties adds rules
+    EXPECT_EQ(string("ETHERNET"), ((*xcastImpl).*interfaceType)("eth0"));
+    EXPECT_EQ(string("WIFI"), ((*xcastImpl).*interfaceType)("wlan0"));
+    if (!XCastManager::getInstance()->getInterfaceTypeRules(deviceRules) || deviceRules.empty())
+    {
+        EXPECT_EQ(string(""), ((*xcastImpl).*interfaceType)("eth1"));
+        EXPECT_EQ(string(""), ((*xcastImpl).*interfaceType)("wlan1"));
+    }
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, gdialCallStats)
+{
+    Core::hresult status = createResources();
+    XCastManager* xcastManager = XCastManager::getInstance();
+    XCastManager::GDialCallStats stateBefore, probeBefore, versionBefore, stats;
+    JsonObject result;
+
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_GET_INSTANCE, stats));
+    EXPECT_GE(stats.calls, 1u);
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_APPLICATION_STATE_CHANGED, stateBefore));
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_LIVENESS_PROBE, probeBefore));
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_GET_PROTOCOL_VERSION, versionBefore));
+
+    EXPECT_CALL(*p_gdialserviceImplMock, ApplicationStateChanged(::testing::_, ::testing::_, ::testing::_, ::testing::_))
+        .WillOnce(::testing::Return(GDIAL_SERVICE_ERROR_NONE));
+    EXPECT_CALL(*p_gdialserviceImplMock, getProtocolVersion())
+        .WillOnce(::testing::Return(std::string("2.2.1")));
+
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("setApplicationState"), _T("{\"applicationName\": \"NetflixApp\", \"state\":\"running\", \"applicationId\": \"1234\", \"error\": \"none\"}"), response));
+    EXPECT_EQ(XCastManager::GDIAL_PROBE_ALIVE, xcastManager->probeGDialService());
+
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_APPLICATION_STATE_CHANGED, stats));
+    EXPECT_EQ(stateBefore.calls + 1, stats.calls);
+    EXPECT_EQ(stateBefore.errors, stats.errors);
+    uint64_t bucketTotal = 0;
+    for (uint64_t count : stats.histogram)
+    {
+        bucketTotal += count;
+    }
+    EXPECT_EQ(stats.calls, bucketTotal);
+    const uint64_t stateCalls = stats.calls;
+
+    // The probe is counted on its own, not as a client getProtocolVersion
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_LIVENESS_PROBE, stats));
+    EXPECT_EQ(probeBefore.calls + 1, stats.calls);
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_GET_PROTOCOL_VERSION, stats));
+    EXPECT_EQ(versionBefore.calls, stats.calls);
+    EXPECT_FALSE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_COUNT, stats));
+
+    // Same counters over JSON-RPC
+    bool foundStateChanged = false, foundProbe = false;
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("getGDialCallStats"), _T("{}"), response));
+    ASSERT_TRUE(result.FromString(response));
+    EXPECT_TRUE(result["success"].Boolean());
+    JsonArray callStats = result["stats"].Array();
+    for (uint16_t index = 0; index < callStats.Length(); ++index)
+    {
+        JsonObject operation = callStats[index].Object();
+        if (operation["operation"].String() == "ApplicationStateChanged")
+        {
+            foundStateChanged = true;
+            EXPECT_EQ(stateCalls, static_cast<uint64_t>(operation["calls"].Number()));
+            // Every call lands in one bucket, the bounds are the fixed <100us .. <1s limits
+            JsonArray histogram = operation["histogram"].Array();
+            JsonArray bucketBounds = operation["bucketBoundsMicros"].Array();
+            ASSERT_EQ(XCastManager::GDIAL_LATENCY_BUCKETS, histogram.Length());
+            ASSERT_EQ(XCastManager::GDIAL_LATENCY_BUCKETS - 1, bucketBounds.Length());
+            uint64_t histogramTotal = 0;
+            for (uint16_t bucket = 0; bucket < histogram.Length(); ++bucket)
+            {
+                histogramTotal += static_cast<uint64_t>(histogram[bucket].Number());
+            }
+            EXPECT_EQ(stateCalls, histogramTotal);
+            EXPECT_EQ(100u, static_cast<uint64_t>(bucketBounds[0].Number()));
+            EXPECT_EQ(1000000u, static_cast<uint64_t>(bucketBounds[XCastManager::GDIAL_LATENCY_BUCKETS - 2].Number()));
+        }
+        else if (operation["operation"].String() == "livenessProbe")
+        {
+            foundProbe = true;
+            EXPECT_EQ(probeBefore.calls + 1, static_cast<uint64_t>(operation["calls"].Number()));
+        }
+    }
+    EXPECT_TRUE(foundStateChanged);
+    EXPECT_TRUE(foundProbe);
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, initializeConcurrentCalls)
+{
+    Core::hresult status = createResources();
+    XCastManager* xcastManager = XCastManager::getInstance();
+    XCastManager::GDialCallStats before, stats;
+    const std::string modelName = xcastManager->getModelName();
+    std::atomic<int> started(0);
+
+    xcastManager->deinitialize();
+    EXPECT_EQ(0, xcastManager->isGDialStarted());
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_GET_INSTANCE, before));
+
+    // Set before the gather, it is kept over the device.properties value
+    xcastManager->setModelName("GatherModel");
+    auto initialize = [&]() {
+        if (xcastManager->initialize(mServiceMock, "eth0", "ETHERNET", false))
+        {
+            ++started;
+        }
+    };
+    std::thread first(initialize);
+    std::thread second(initialize);
+    first.join();
+    second.join();
+
+    // Both callers see gdial up, only one of them started it
+    EXPECT_EQ(2, started.load());
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_GET_INSTANCE, stats));
+    EXPECT_EQ(before.calls + 1, stats.calls);
+    EXPECT_EQ(1, xcastManager->isGDialStarted());
+    EXPECT_EQ(std::string("eth0"), xcastManager->getGDialInterface());
+    EXPECT_EQ(std::string("GatherModel"), xcastManager->getModelName());
+
+    xcastManager->setModelName(modelName);
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, rfcRefreshWithoutChange)
+{
+    Core::hresult status = createResources();
+
+    // Same RFC values as at activation, nothing to reconfigure
+    EXPECT_FALSE(XCastManager::getInstance()->refreshRFCInputs());
+    EXPECT_EQ(1, XCastManager::getInstance()->isGDialStarted());
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, gdialLivenessProbe)
+{
+    Core::hresult status = createResources();
+    XCastManager::LivenessStats stats;
+
+    EXPECT_CALL(*p_gdialserviceImplMock, getProtocolVersion())
+            .WillOnce(::testing::Invoke(
+                []() {
+                    return std::string("2.2.1");
+                }));
+    EXPECT_EQ(XCastManager::GDIAL_PROBE_ALIVE, XCastManager::getInstance()->probeGDialService());
+    XCastManager::getInstance()->getLivenessStats(stats);
+    EXPECT_GE(stats.probes, 1u);
+    EXPECT_EQ(0u, stats.reconnects);
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, gdialLivenessProbeTimeout)
+{
+    Core::hresult status = createResources();
+    XCastManager::LivenessStats before, stats;
+    XCastManager::GDialCallStats probeBefore, probeStats;
+    std::promise<void> release;
+    std::shared_future<void> released(release.get_future());
+    XCastManager::getInstance()->getLivenessStats(before);
+    EXPECT_TRUE(XCastManager::getInstance()->getGDialCallStats(XCastManager::GDIAL_OP_LIVENESS_PROBE, probeBefore));
+
+    EXPECT_CALL(*p_gdialserviceImplMock, getProtocolVersion())
+            .WillOnce(::testing::Invoke(
+                [released]() {
+                    released.wait();
+                    return std::string("2.2.1");
+                }));
+    // A hung gdial no longer holds up the prober, the probe gives up after its bounded wait
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(XCastManager::GDIAL_PROBE_TIMEOUT, XCastManager::getInstance()->probeGDialService());
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    EXPECT_LT(elapsed.count(), 5000);
+    XCastManager::getInstance()->getLivenessStats(stats);
+    EXPECT_EQ(before.timeouts + 1, stats.timeouts);
+    EXPECT_EQ(before.failures + 1, stats.failures);
+    EXPECT_EQ(before.reconnects, stats.reconnects);
+
+    // The stuck call completes on its own thread once gdial answers
+    release.set_value();
+    do {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        XCastManager::getInstance()->getGDialCallStats(XCastManager::GDIAL_OP_LIVENESS_PROBE, probeStats);
+    } while (probeStats.calls < probeBefore.calls + 1);
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, gdialLivenessLossReconnects)
+{
+    Core::hresult status = createResources();
+    XCastManager::LivenessStats before, stats;
+    XCastManager::getInstance()->getLivenessStats(before);
+
+    EXPECT_CALL(*p_gdialserviceImplMock, getProtocolVersion())
+            .Times(2)
+            .WillRepeatedly(::testing::Invoke(
+                []() {
+                    return std::string("");
+                }));
+    // A single unanswered probe only marks gdial as suspect
+    EXPECT_EQ(XCastManager::GDIAL_PROBE_NO_ANSWER, XCastManager::getInstance()->probeGDialService());
+    XCastManager::getInstance()->getLivenessStats(stats);
+    EXPECT_EQ(before.reconnects, stats.reconnects);
+
+    // The confirming probe restarts gdial, which reconnects in the background
+    EXPECT_EQ(XCastManager::GDIAL_PROBE_NO_ANSWER, XCastManager::getInstance()->probeGDialService());
+    EXPECT_TRUE(XCastManager::getInstance()->waitForInitialize(5000));
+    XCastManager::getInstance()->getLivenessStats(stats);
+    EXPECT_EQ(before.failures + 2, stats.failures);
+    EXPECT_EQ(before.reconnects + 1, stats.reconnects);
+    EXPECT_EQ(before.recoveries + 1, stats.recoveries);
+    EXPECT_EQ(1, XCastManager::getInstance()->isGDialStarted());
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, warmRestartKeepsRegistry)
+{
+    Core::hresult status = createResources();
+    XCastManager* xcastManager = XCastManager::getInstance();
+    XCastManager::GDialCallStats instanceBefore, destroyBefore, stats;
+    auto warmRestart = get(WarmRestartGDialServiceTag{});
+    std::vector<std::string> restoredNames;
+
+    EXPECT_CALL(*p_gdialserviceImplMock, RegisterApplications(::testing::_))
+        .Times(2)
+        .WillOnce(::testing::Return(GDIAL_SERVICE_ERROR_NONE))
+        .WillOnce(::testing::Invoke([&](RegisterAppEntryList* appConfigList)
+            {
+                for (RegisterAppEntry* appEntry : appConfigList->getValues())
+                {
+                    restoredNames.push_back(appEntry->Names);
+                }
+                return GDIAL_SERVICE_ERROR_NONE;
+            }));
+
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("registerApplications"), _T("{\"applications\": [{\"name\": \"WarmApp\",\"prefix\": \"myWarmApp\",\"cors\": \".warm.com\",\"allowStop\": 1}]}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+    const std::string modelName = xcastManager->getModelName();
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_GET_INSTANCE, instanceBefore));
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_DESTROY_INSTANCE, destroyBefore));
+
+    // As on DEEP_SLEEP -> ON: only the gdial instance is replaced, the restored registry goes to the new one
+    ((&(*xcastImpl))->*warmRestart)();
+    EXPECT_TRUE(xcastManager->waitForInitialize(5000));
+
+    EXPECT_EQ(1, xcastManager->isGDialStarted());
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_DESTROY_INSTANCE, stats));
+    EXPECT_EQ(destroyBefore.calls + 1, stats.calls);
+    EXPECT_TRUE(xcastManager->getGDialCallStats(XCastManager::GDIAL_OP_GET_INSTANCE, stats));
+    EXPECT_EQ(instanceBefore.calls + 1, stats.calls);
+    EXPECT_NE(restoredNames.end(), std::find(restoredNames.begin(), restoredNames.end(), std::string("WarmApp")));
+    EXPECT_NE(0u, xcastManager->getRegisteredAppsGeneration());
+    EXPECT_EQ(modelName, xcastManager->getModelName());
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, castAvailabilityEdgeTriggered)
+{
+    Core::hresult status = createResources();
+
+    EXPECT_CALL(*p_gdialserviceImplMock, ActivationChanged(::testing::_,::testing::_))
+        .Times(2)
+        .WillOnce(::testing::Invoke(
+            [&](std::string activation, std::string friendlyname) {
+                EXPECT_EQ(friendlyname, "edgeTest");
                 return GDIAL_SERVICE_ERROR_NONE;
             }))
         .WillOnce(::testing::Invoke(
             [&](std::string activation, std::string friendlyname) {
+                EXPECT_EQ(friendlyname, "edgeTest2");
+                return GDIAL_SERVICE_ERROR_NONE;
+            }));
+
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("setFriendlyName"), _T("{\"friendlyname\": \"edgeTest\"}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+    // Same output again, gdial is not called
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("setFriendlyName"), _T("{\"friendlyname\": \"edgeTest\"}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("setFriendlyName"), _T("{\"friendlyname\": \"edgeTest2\"}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, castOutputNotLockedAcrossGDial)
+{
+    Core::hresult status = createResources();
+    std::promise<void> activationEntered;
+    std::promise<void> activationRelease;
+    std::shared_future<void> released = activationRelease.get_future().share();
+
+    EXPECT_CALL(*p_gdialserviceImplMock, ActivationChanged(::testing::_,::testing::_))
+        .WillOnce(::testing::Invoke(
+            [&activationEntered, released](std::string activation, std::string friendlyname) {
+                EXPECT_EQ(friendlyname, "pushBlocked");
+                activationEntered.set_value();
+                released.wait();
                 return GDIAL_SERVICE_ERROR_NONE;
             }))
+        .WillRepeatedly(::testing::Return(GDIAL_SERVICE_ERROR_NONE));
+
+    Plugin::XCastImplementation* impl = &(*xcastImpl);
+    std::thread pusher([impl]() {
+        Exchange::IXCast::XCastSuccess success;
+        impl->SetFriendlyName("pushBlocked", success);
+    });
+    activationEntered.get_future().wait();
+
+    // gdial is still busy with the first push, deciding that nothing changed must not wait for it
+    auto unchanged = std::async(std::launch::async, [impl]() {
+        Exchange::IXCast::XCastSuccess success;
+        impl->SetFriendlyName("pushBlocked", success);
+        return success.success;
+    });
+    EXPECT_EQ(std::future_status::ready, unchanged.wait_for(std::chrono::seconds(2)));
+
+    activationRelease.set_value();
+    pusher.join();
+    EXPECT_TRUE(unchanged.get());
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, reconnectSkipsAcknowledgedRegistry)
+{
+    Core::hresult status = createResources();
+    XCastManager* xcastManager = XCastManager::getInstance();
+    Plugin::XCastImplementation* impl = &(*xcastImpl);
+    auto onConnected = get(OnGDialServiceConnectedTag{});
+    // GDIAL_CONNECT_TIMER, the locate-cast timer found gdial again
+    const auto timerReconnect = static_cast<GDialConnectReasonOf<decltype(onConnected)>::type>(1);
+
+    EXPECT_CALL(*p_gdialserviceImplMock, RegisterApplications(::testing::_))
+        .Times(3)
+        .WillOnce(::testing::Return(GDIAL_SERVICE_ERROR_NONE))
+        .WillOnce(::testing::Return(GDIAL_SERVICE_INVALID_PARAM_ERROR))
+        .WillOnce(::testing::Return(GDIAL_SERVICE_ERROR_NONE));
+
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("registerApplications"), _T("{\"applications\": [{\"name\": \"ReconnectApp\",\"prefix\": \"myReconnectApp\",\"cors\": \".reconnect.com\",\"allowStop\": 1}]}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+    const uint64_t acked = xcastManager->getRegisteredAppsGeneration();
+    EXPECT_NE(0u, acked);
+
+    // gdial already has this generation, the reconnect does not push it again
+    (impl->*onConnected)(true, "eth0", timerReconnect, std::chrono::steady_clock::now());
+    EXPECT_EQ(acked, xcastManager->getRegisteredAppsGeneration());
+
+    // A rejected push leaves gdial behind, the next reconnect catches it up once
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("registerApplications"), _T("{\"applications\": [{\"name\": \"ReconnectApp2\",\"prefix\": \"myReconnectApp2\",\"cors\": \".reconnect.com\",\"allowStop\": 0}]}"), response));
+    EXPECT_EQ(acked, xcastManager->getRegisteredAppsGeneration());
+    (impl->*onConnected)(true, "eth0", timerReconnect, std::chrono::steady_clock::now());
+    const uint64_t caughtUp = xcastManager->getRegisteredAppsGeneration();
+    EXPECT_GT(caughtUp, acked);
+    (impl->*onConnected)(true, "eth0", timerReconnect, std::chrono::steady_clock::now());
+    EXPECT_EQ(caughtUp, xcastManager->getRegisteredAppsGeneration());
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, registrationDuringActivationReachesGDial)
+{
+    Core::hresult status = createResources();
+    XCastManager* xcastManager = XCastManager::getInstance();
+    Plugin::XCastImplementation* impl = &(*xcastImpl);
+    auto connect = get(ConnectToGDialServiceTag{});
+    // GDIAL_CONNECT_ACTIVATION, gdial is brought up in the background after Initialize
+    const auto activation = static_cast<GDialConnectReasonOf<decltype(get(OnGDialServiceConnectedTag{}))>::type>(0);
+    std::vector<std::string> registeredNames;
+
+    EXPECT_CALL(*p_gdialserviceImplMock, RegisterApplications(::testing::_))
+        .Times(1)
+        .WillOnce(::testing::Invoke([&](RegisterAppEntryList* appConfigList)
+            {
+                for (RegisterAppEntry* appEntry : appConfigList->getValues())
+                {
+                    registeredNames.push_back(appEntry->Names);
+                }
+                return GDIAL_SERVICE_ERROR_NONE;
+            }));
+
+    // A client registers before the activation's gdial instance exists, the push has nowhere to go
+    xcastManager->deinitialize();
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("registerApplications"), _T("{\"applications\": [{\"name\": \"ActivationApp\",\"prefix\": \"myActivationApp\",\"cors\": \".activation.com\",\"allowStop\": 1}]}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+    EXPECT_EQ(0u, xcastManager->getRegisteredAppsGeneration());
+
+    // Once gdial is up the activation path catches it up
+    EXPECT_TRUE((impl->*connect)(activation));
+    EXPECT_TRUE(xcastManager->waitForInitialize(5000));
+    EXPECT_EQ(1, xcastManager->isGDialStarted());
+    EXPECT_NE(registeredNames.end(), std::find(registeredNames.begin(), registeredNames.end(), std::string("ActivationApp")));
+    EXPECT_NE(0u, xcastManager->getRegisteredAppsGeneration());
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, registrySnapshotPublication)
+{
+    Core::hresult status = createResources();
+    XCastManager* xcastManager = XCastManager::getInstance();
+    Plugin::XCastImplementation* impl = &(*xcastImpl);
+    std::promise<std::vector<std::string>> readDone;
+    std::future<std::vector<std::string>> readNames = readDone.get_future();
+    std::thread reader;
+
+    EXPECT_CALL(*p_gdialserviceImplMock, RegisterApplications(::testing::_))
+        .Times(1)
+        .WillOnce(::testing::Invoke([&](RegisterAppEntryList* appConfigList)
+            {
+                // The registry is published before the push and readers do not wait for gdial
+                reader = std::thread([impl, &readDone]() {
+                    Exchange::IXCast::IApplicationInfoIterator* appInfoList = nullptr;
+                    Exchange::IXCast::ApplicationInfo appInfo;
+                    std::vector<std::string> names;
+                    uint32_t total = 0;
+                    impl->GetRegisteredApplications(0, 0, DYNAMIC_APP_FIELD_NAME, appInfoList, total);
+                    if (nullptr != appInfoList)
+                    {
+                        while (appInfoList->Next(appInfo))
+                        {
+                            names.push_back(appInfo.appName);
+                        }
+                        appInfoList->Release();
+                    }
+                    readDone.set_value(names);
+                });
+                EXPECT_EQ(std::future_status::ready, readNames.wait_for(std::chrono::seconds(2)));
+                return GDIAL_SERVICE_ERROR_NONE;
+            }));
+
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("registerApplications"), _T("{\"applications\": [{\"name\": \"SnapshotApp\",\"prefix\": \"mySnapshotApp\",\"cors\": \".snapshot.com\",\"allowStop\": 1}]}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+    ASSERT_TRUE(reader.joinable());
+    reader.join();
+    std::vector<std::string> names = readNames.get();
+    EXPECT_NE(names.end(), std::find(names.begin(), names.end(), std::string("SnapshotApp")));
+
+    // A snapshot older than the one gdial acknowledged is dropped without a gdial call
+    const uint64_t acked = xcastManager->getRegisteredAppsGeneration();
+    ASSERT_NE(0u, acked);
+    std::shared_ptr<DynamicAppRegistry> stale = std::make_shared<DynamicAppRegistry>();
+    stale->generation = acked - 1;
+    xcastManager->registerApplications(stale);
+    EXPECT_EQ(acked, xcastManager->getRegisteredAppsGeneration());
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, metadataNotLockedAcrossGDial)
+{
+    Core::hresult status = createResources();
+    XCastManager* xcastManager = XCastManager::getInstance();
+    std::promise<void> pushEntered, pushRelease;
+    std::shared_future<void> released(pushRelease.get_future());
+
+    EXPECT_CALL(*p_gdialserviceImplMock, RegisterApplications(::testing::_))
+        .WillOnce(::testing::Invoke([&pushEntered, released](RegisterAppEntryList* appConfigList)
+            {
+                pushEntered.set_value();
+                released.wait();
+                return GDIAL_SERVICE_ERROR_NONE;
+            }));
+    // Queried once per gdial instance, then served from the metadata snapshot
+    EXPECT_CALL(*p_gdialserviceImplMock, getProtocolVersion())
+        .Times(1)
+        .WillOnce(::testing::Return(std::string("2.2.1")));
+
+    std::shared_ptr<DynamicAppRegistry> registry = std::make_shared<DynamicAppRegistry>();
+    registry->generation = xcastManager->getRegisteredAppsGeneration() + 1;
+    registry->apps.push_back(std::make_shared<const DynamicAppConfig>("LockApp", "myLockApp", "", 1, "", ""));
+    std::thread pusher([xcastManager, registry]() { xcastManager->registerApplications(registry); });
+    pushEntered.get_future().wait();
+
+    // gdial is busy with the push, the getters do not wait for it
+    auto getters = std::async(std::launch::async, [xcastManager]() {
+        xcastManager->getModelName();
+        xcastManager->getManufacturerName();
+        xcastManager->isDefaultApplication("Netflix");
+        return xcastManager->getRegisteredAppsGeneration();
+    });
+    EXPECT_EQ(std::future_status::ready, getters.wait_for(std::chrono::seconds(2)));
+
+    pushRelease.set_value();
+    pusher.join();
+    EXPECT_EQ(registry->generation - 1, getters.get());
+    EXPECT_EQ(registry->generation, xcastManager->getRegisteredAppsGeneration());
+
+    EXPECT_EQ(std::string("2.2.1"), xcastManager->getProtocolVersion());
+    EXPECT_EQ(std::string("2.2.1"), xcastManager->getProtocolVersion());
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, registerApplicationsCoalescing)
+{
+    Core::hresult status = createResources();
+    XCastManager* xcastManager = XCastManager::getInstance();
+    std::promise<void> activationEntered, activationRelease;
+    std::shared_future<void> releaseActivation(activationRelease.get_future());
+    std::vector<std::string> registeredNames;
+
+    // Keep gdial busy so the registrations below queue up behind the activation
+    EXPECT_CALL(*p_gdialserviceImplMock, ActivationChanged(::testing::_,::testing::_))
         .WillOnce(::testing::Invoke(
             [&](std::string activation, std::string friendlyname) {
-                wg.Done();
+                activationEntered.set_value();
+                releaseActivation.wait();
                 return GDIAL_SERVICE_ERROR_NONE;
             }));
+    EXPECT_CALL(*p_gdialserviceImplMock, RegisterApplications(::testing::_))
+        .Times(1)
+        .WillOnce(::testing::Invoke([&](RegisterAppEntryList* appConfigList)
+            {
+                for (RegisterAppEntry* appEntry : appConfigList->getValues())
+                {
+                    registeredNames.push_back(appEntry->Names);
+                }
+                return GDIAL_SERVICE_ERROR_NONE;
+            }));
+
+    std::shared_ptr<DynamicAppRegistry> newer = std::make_shared<DynamicAppRegistry>();
+    newer->generation = 1002;
+    newer->apps.push_back(std::make_shared<const DynamicAppConfig>("Netflix", "myNetflix", "", 1, "", ""));
+    newer->apps.push_back(std::make_shared<const DynamicAppConfig>("YouTube", "myYouTube", "", 1, "", ""));
+    std::shared_ptr<DynamicAppRegistry> older = std::make_shared<DynamicAppRegistry>();
+    older->generation = 1001;
+    older->apps.push_back(std::make_shared<const DynamicAppConfig>("Netflix", "myNetflix", "", 1, "", ""));
+
+    XCastManager::CommandQueueStats before, stats;
+    size_t depth = 0;
+    xcastManager->getCommandQueueStats(before, depth);
+
+    std::thread activation([xcastManager]() { xcastManager->enableCastService("coalesce", true); });
+    activationEntered.get_future().wait();
+    // The newer snapshot is submitted first, the older one arrives late
+    std::thread newerSubmit([xcastManager, newer]() { xcastManager->registerApplications(newer); });
+    do {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        xcastManager->getCommandQueueStats(stats, depth);
+    } while (stats.submitted < before.submitted + 2);
+    std::thread olderSubmit([xcastManager, older]() { xcastManager->registerApplications(older); });
+    do {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        xcastManager->getCommandQueueStats(stats, depth);
+    } while (stats.submitted < before.submitted + 3);
+    EXPECT_EQ(1u, depth);
+    EXPECT_EQ(before.coalesced + 1, stats.coalesced);
+
+    activationRelease.set_value();
+    activation.join();
+    newerSubmit.join();
+    olderSubmit.join();
+
+    ASSERT_EQ(2u, registeredNames.size());
+    EXPECT_EQ(string("Netflix"), registeredNames[0]);
+    EXPECT_EQ(string("YouTube"), registeredNames[1]);
+    EXPECT_EQ(1002u, xcastManager->getRegisteredAppsGeneration());
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, registrationResendAllocatesNothing)
+{
+    Core::hresult status = createResources();
+    XCastManager* xcastManager = XCastManager::getInstance();
+    XCastManager::RegistrationStats before, stats;
+
+    EXPECT_CALL(*p_gdialserviceImplMock, RegisterApplications(::testing::_))
+        .Times(1)
+        .WillOnce(::testing::Return(GDIAL_SERVICE_ERROR_NONE));
+
+    // A client resends the same list: new entries each time, same content
+    auto makeRegistry = [](uint64_t generation) {
+        std::shared_ptr<DynamicAppRegistry> registry = std::make_shared<DynamicAppRegistry>();
+        registry->generation = generation;
+        registry->apps.push_back(std::make_shared<const DynamicAppConfig>("YouTube", "myYouTube", ".youtube.com", 1, "", ""));
+        registry->apps.push_back(std::make_shared<const DynamicAppConfig>("Netflix", "myNetflix", ".netflix.com", 0, "", ""));
+        registry->apps.push_back(std::make_shared<const DynamicAppConfig>("Amazon", "myAmazon", "", 1, "", ""));
+        return registry;
+    };
+    const uint64_t generation = xcastManager->getRegisteredAppsGeneration();
+
+    xcastManager->getRegistrationStats(before);
+    xcastManager->registerApplications(makeRegistry(generation + 1));
+    xcastManager->getRegistrationStats(stats);
+    EXPECT_EQ(before.pushed + 1, stats.pushed);
+    EXPECT_EQ(before.gdialAllocations + 4, stats.gdialAllocations);
+
+    before = stats;
+    xcastManager->registerApplications(makeRegistry(generation + 2));
+    xcastManager->getRegistrationStats(stats);
+    EXPECT_EQ(before.skipped + 1, stats.skipped);
+    EXPECT_EQ(before.pushed, stats.pushed);
+    EXPECT_EQ(before.gdialAllocations, stats.gdialAllocations);
+    EXPECT_EQ(before.indexPoolMisses, stats.indexPoolMisses);
+    EXPECT_EQ(before.indexPoolHits + 1, stats.indexPoolHits);
+    EXPECT_EQ(generation + 2, xcastManager->getRegisteredAppsGeneration());
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, getRegisteredApplications)
+{
+    Core::hresult status = createResources();
+    JsonObject result;
+    JsonArray applications;
 
     EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("registerApplications"), _T("{\"applications\": [{\"name\": \"Youtube\",\"prefix\": \"myYouTube\",\"cors\": \".youtube.com\",\"query\": \"source_type=12\",\"payload\": \"youtube_payload\",\"allowStop\": 1 },{\"name\": \"Netflix\",\"prefix\": \"myNetflix\",\"cors\": \".netflix.com\",\"query\": \"source_type=12\",\"payload\": \"netflix_payload\",\"allowStop\": 0}]}"), response));
     EXPECT_EQ(response, string("{\"success\":true}"));
 
-    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("unregisterApplications"), _T("{\"applications\": [\"Youtube\"]}"), response));
+    // Names only, one entry per page
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("getRegisteredApplications"), _T("{\"offset\": 0, \"limit\": 1, \"fields\": 1}"), response));
+    ASSERT_TRUE(result.FromString(response));
+    EXPECT_TRUE(result["success"].Boolean());
+    const uint32_t total = static_cast<uint32_t>(result["total"].Number());
+    EXPECT_GE(total, 2u);
+    applications = result["applications"].Array();
+    ASSERT_EQ(1, applications.Length());
+    JsonObject namesOnly = applications[0].Object();
+    EXPECT_FALSE(namesOnly["name"].String().empty());
+    EXPECT_FALSE(namesOnly.HasLabel("prefix"));
+    EXPECT_FALSE(namesOnly.HasLabel("cors"));
+    EXPECT_FALSE(namesOnly.HasLabel("query"));
+    EXPECT_FALSE(namesOnly.HasLabel("payload"));
+    EXPECT_FALSE(namesOnly.HasLabel("allowStop"));
+
+    // Prefix and payload only, no name key
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("getRegisteredApplications"), _T("{\"offset\": 0, \"limit\": 1, \"fields\": 34}"), response));
+    ASSERT_TRUE(result.FromString(response));
+    applications = result["applications"].Array();
+    ASSERT_EQ(1, applications.Length());
+    JsonObject prefixAndPayload = applications[0].Object();
+    EXPECT_TRUE(prefixAndPayload.HasLabel("prefix"));
+    EXPECT_TRUE(prefixAndPayload.HasLabel("payload"));
+    EXPECT_FALSE(prefixAndPayload.HasLabel("name"));
+    EXPECT_FALSE(prefixAndPayload.HasLabel("cors"));
+    EXPECT_FALSE(prefixAndPayload.HasLabel("allowStop"));
+
+    // All fields, whole registry
+    bool foundNetflix = false;
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("getRegisteredApplications"), _T("{}"), response));
+    ASSERT_TRUE(result.FromString(response));
+    applications = result["applications"].Array();
+    EXPECT_EQ(total, applications.Length());
+    for (uint16_t index = 0; index < applications.Length(); ++index)
+    {
+        JsonObject application = applications[index].Object();
+        if (application["name"].String() == "Netflix")
+        {
+            foundNetflix = true;
+            EXPECT_EQ(application["prefix"].String(), string("myNetflix"));
+            EXPECT_EQ(application["cors"].String(), string(".netflix.com"));
+            EXPECT_EQ(application["payload"].String(), string("netflix_payload"));
+            EXPECT_FALSE(application["allowStop"].Boolean());
+        }
+    }
+    EXPECT_TRUE(foundNetflix);
+
+    // Offset past the end
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("getRegisteredApplications"), _T("{\"offset\": ") + std::to_string(total) + _T(", \"limit\": 10}"), response));
+    ASSERT_TRUE(result.FromString(response));
+    EXPECT_EQ(0, result["applications"].Array().Length());
+    EXPECT_EQ(total, static_cast<uint32_t>(result["total"].Number()));
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
+TEST_F(XCastTest, updateApplicationsBatch)
+{
+    Core::hresult status = createResources();
+    std::vector<std::vector<string>> pushes;
+
+    EXPECT_CALL(*p_gdialserviceImplMock, RegisterApplications(::testing::_))
+        .Times(3)
+        .WillRepeatedly(::testing::Invoke([&pushes](RegisterAppEntryList* appConfigList)
+            {
+                std::vector<string> names;
+                for (RegisterAppEntry* appEntry : appConfigList->getValues())
+                {
+                    names.push_back(appEntry->Names);
+                }
+                pushes.push_back(std::move(names));
+                return GDIAL_SERVICE_ERROR_NONE;
+            }));
+
+    // Replace whatever is registered with exactly two apps
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("updateApplications"), _T("{\"replaceAll\": true, \"applications\": [{\"name\": \"BatchAppA\",\"prefix\": \"myBatchAppA\",\"allowStop\": 1 },{\"name\": \"BatchAppB\",\"prefix\": \"myBatchAppB\",\"allowStop\": false}]}"), response));
     EXPECT_EQ(response, string("{\"success\":true}"));
 
-    // Added to trigger registerApplication handling based on timer
-    ASSERT_NE(_networkManagerNotification, nullptr);
-    _networkManagerNotification->onActiveInterfaceChange("eth0", "wlan0");
-    usleep(50);
+    // Swap A for C in a single update
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("updateApplications"), _T("{\"applications\": [{\"name\": \"BatchAppC\",\"prefix\": \"myBatchAppC\",\"allowStop\": true}], \"remove\": [\"BatchAppA\"]}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
 
-    wg.Wait();
+    JsonObject result;
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("getRegisteredApplications"), _T("{}"), response));
+    ASSERT_TRUE(result.FromString(response));
+    EXPECT_EQ(2, result["total"].Number());
+    JsonArray applications = result["applications"].Array();
+    ASSERT_EQ(2, applications.Length());
+    EXPECT_EQ(string("BatchAppB"), applications[0].Object()["name"].String());
+    EXPECT_FALSE(applications[0].Object()["allowStop"].Boolean());
+    EXPECT_EQ(string("BatchAppC"), applications[1].Object()["name"].String());
+    EXPECT_TRUE(applications[1].Object()["allowStop"].Boolean());
+
+    // Leave an empty registry behind
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("updateApplications"), _T("{\"replaceAll\": true}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+
+    ASSERT_EQ(3u, pushes.size());
+    EXPECT_EQ(pushes[0], std::vector<string>({"BatchAppA", "BatchAppB"}));
+    EXPECT_EQ(pushes[1], std::vector<string>({"BatchAppB", "BatchAppC"}));
+    EXPECT_TRUE(pushes[2].empty());
 
     if (Core::ERROR_NONE == status)
     {
@@ -701,6 +1680,61 @@ TEST_F(XCastTest, onApplicationLaunchRequest)
     }
 }
 
+TEST_F(XCastTest, launchRequestMatchesKnownApplications)
+{
+    Core::hresult status = createResources();
+    XCastManagerTestWrapper testWrapper;
+    Core::Event onRegisteredLaunch(false, true);
+    Core::Event onDefaultLaunch(false, true);
+
+    EXPECT_EQ(Core::ERROR_NONE, mJsonRpcHandler.Invoke(connection, _T("registerApplications"), _T("{\"applications\": [{\"name\": \"Youtube\",\"prefix\": \"myYouTube\",\"cors\": \".youtube.com\",\"query\": \"source_type=12\",\"payload\": \"youtube_payload\",\"allowStop\": 1 }]}"), response));
+    EXPECT_EQ(response, string("{\"success\":true}"));
+    EXPECT_TRUE(testWrapper.testApplyDefaultAppList("Amazon:Pandora"));
+
+    // The unknown name is sent first, were it dispatched it would take the first expectation
+    EXPECT_CALL(*mServiceMock, Submit(::testing::_, ::testing::_))
+        .Times(2)
+        .WillOnce(::testing::Invoke(
+            [&](const uint32_t, const Core::ProxyType<Core::JSON::IElement>& json) {
+                string text;
+                EXPECT_TRUE(json->ToString(text));
+                EXPECT_EQ(text, string(_T("{\"jsonrpc\":\"2.0\",\"method\":\"client.events.onApplicationLaunchRequest\",\"params\":{\"applicationName\":\"YOUTUBE\",\"parameter\":\"http:\\/\\/youtube.com\"}}")));
+                onRegisteredLaunch.SetEvent();
+                return Core::ERROR_NONE;
+            }))
+        .WillOnce(::testing::Invoke(
+            [&](const uint32_t, const Core::ProxyType<Core::JSON::IElement>& json) {
+                string text;
+                EXPECT_TRUE(json->ToString(text));
+                EXPECT_EQ(text, string(_T("{\"jsonrpc\":\"2.0\",\"method\":\"client.events.onApplicationLaunchRequest\",\"params\":{\"applicationName\":\"amazon\",\"parameter\":\"http:\\/\\/amazon.com\"}}")));
+                onDefaultLaunch.SetEvent();
+                return Core::ERROR_NONE;
+            }));
+
+    EVENT_SUBSCRIBE(0, _T("onApplicationLaunchRequest"), _T("client.events"), message);
+
+    GDialNotifier* gdialNotifier = gdialService::getObserverHandle();
+    ASSERT_NE(gdialNotifier, nullptr);
+
+    // Neither registered nor a default app
+    gdialNotifier->onApplicationLaunchRequest("UnknownApp", "http://unknown.com");
+    // Registered and default names both match regardless of case
+    gdialNotifier->onApplicationLaunchRequest("YOUTUBE", "http://youtube.com");
+    EXPECT_EQ(Core::ERROR_NONE, onRegisteredLaunch.Lock(5000));
+    gdialNotifier->onApplicationLaunchRequest("amazon", "http://amazon.com");
+    EXPECT_EQ(Core::ERROR_NONE, onDefaultLaunch.Lock(5000));
+
+    EVENT_UNSUBSCRIBE(0, _T("onApplicationLaunchRequest"), _T("client.events"), message);
+
+    // An empty default list lets every name through again for the following tests
+    EXPECT_TRUE(testWrapper.testApplyDefaultAppList(""));
+
+    if (Core::ERROR_NONE == status)
+    {
+        releaseResources();
+    }
+}
+
 TEST_F(XCastTest, onApplicationStopRequest)
 {
     Core::hresult status = createResources();
@@ -1293,3 +2327,195 @@ TEST_F(XCastManagerTest, Integration_GetSerialAndGenerateUUID)
     std::string generatedUUID2 = testWrapper.testGenerateUUIDv5FromSerialNumber(retrievedSerial);
     EXPECT_EQ(generatedUUID, generatedUUID2);
 }
+
+// Tests for the persisted receiver id cache
+TEST_F(XCastManagerTest, identityCacheFile_PersistentPath)
+{
+    EXPECT_TRUE(testWrapper.testGetIdentityCacheFile(nullptr).empty());
+
+    ON_CALL(mockService, PersistentPath())
+        .WillByDefault(::testing::Return(string("")));
+    EXPECT_TRUE(testWrapper.testGetIdentityCacheFile(&mockService).empty());
+
+    ON_CALL(mockService, PersistentPath())
+        .WillByDefault(::testing::Return(string("/tmp/XCast")));
+    EXPECT_EQ(string("/tmp/XCast/xcast_identity.cache"), testWrapper.testGetIdentityCacheFile(&mockService));
+
+    ON_CALL(mockService, PersistentPath())
+        .WillByDefault(::testing::Return(string("/tmp/XCast/")));
+    EXPECT_EQ(string("/tmp/XCast/xcast_identity.cache"), testWrapper.testGetIdentityCacheFile(&mockService));
+}
+
+TEST_F(XCastManagerTest, identityCache_RoundTrip)
+{
+    const std::string cacheFile = "/tmp/xcast_identity_l1.cache";
+    std::string receiverId;
+
+    testWrapper.testSaveIdentityCache(cacheFile, "receiver-1234", "/tmp/gpid.txt", "stampA");
+    EXPECT_TRUE(testWrapper.testLoadIdentityCache(cacheFile, "stampA", receiverId));
+    EXPECT_EQ(string("receiver-1234"), receiverId);
+
+    // Any change of the sources invalidates the cached id
+    receiverId.clear();
+    EXPECT_FALSE(testWrapper.testLoadIdentityCache(cacheFile, "stampB", receiverId));
+    EXPECT_TRUE(receiverId.empty());
+
+    // The same id under the same stamp leaves the file untouched
+    testWrapper.testSaveIdentityCache(cacheFile, "receiver-1234", "DeviceInfo", "stampA");
+    {
+        std::ifstream cached(cacheFile);
+        const std::string content((std::istreambuf_iterator<char>(cached)), std::istreambuf_iterator<char>());
+        EXPECT_NE(std::string::npos, content.find("source=/tmp/gpid.txt"));
+    }
+    // A new stamp is written even when the id stays the same
+    testWrapper.testSaveIdentityCache(cacheFile, "receiver-1234", "/tmp/gpid.txt", "stampB");
+    EXPECT_TRUE(testWrapper.testLoadIdentityCache(cacheFile, "stampB", receiverId));
+    EXPECT_EQ(string("receiver-1234"), receiverId);
+
+    // No persistent path, no cache
+    EXPECT_FALSE(testWrapper.testLoadIdentityCache("", "stampA", receiverId));
+    remove(cacheFile.c_str());
+    EXPECT_FALSE(testWrapper.testLoadIdentityCache(cacheFile, "stampA", receiverId));
+}
+
+TEST_F(XCastManagerTest, identitySourcesStamp_ContentBased)
+{
+    const char* gpidFile = "/tmp/gpid.txt";
+    std::ifstream existing(gpidFile);
+    if (existing)
+    {
+        TEST_LOG("%s belongs to the device, not rewriting it", gpidFile);
+        EXPECT_EQ(testWrapper.testGetIdentitySourcesStamp(), testWrapper.testGetIdentitySourcesStamp());
+        return;
+    }
+
+    {
+        std::ofstream gpid(gpidFile, std::ofstream::trunc);
+        gpid << "{\"deviceId\": \"ABC123\"}";
+    }
+    const std::string stamp = testWrapper.testGetIdentitySourcesStamp();
+    // FNV-1a of the content and its size, the same value in every build
+    EXPECT_EQ(0u, stamp.find("8cb93df2b09576b8:22;"));
+
+    // Rewritten with the same content at boot: same stamp even though the mtime moved
+    sleep(1);
+    {
+        std::ofstream gpid(gpidFile, std::ofstream::trunc);
+        gpid << "{\"deviceId\": \"ABC123\"}";
+    }
+    EXPECT_EQ(stamp, testWrapper.testGetIdentitySourcesStamp());
+
+    {
+        std::ofstream gpid(gpidFile, std::ofstream::trunc);
+        gpid << "{\"deviceId\": \"XYZ789\"}";
+    }
+    EXPECT_NE(stamp, testWrapper.testGetIdentitySourcesStamp());
+
+    remove(gpidFile);
+}
+
+TEST_F(XCastManagerTest, envGetValue_DevicePropertiesCache)
+{
+    const std::string propertiesFile = "/tmp/xcast_test_device.properties";
+    std::string value;
+    {
+        std::ofstream out(propertiesFile, std::ofstream::trunc);
+        ASSERT_TRUE(out.good());
+        out << "MODEL_NUM=PX051AEI\nMFG_NAME=Acme\nMODEL_NUM=IGNORED\nBROKEN_LINE\n=novalue\n";
+    }
+    testWrapper.testSetDevicePropertiesFile(propertiesFile);
+
+    EXPECT_TRUE(testWrapper.testEnvGetValue("MODEL_NUM", value));
+    EXPECT_EQ("PX051AEI", value);
+    EXPECT_TRUE(testWrapper.testEnvGetValue("MFG_NAME", value));
+    EXPECT_EQ("Acme", value);
+    EXPECT_FALSE(testWrapper.testEnvGetValue("BROKEN_LINE", value));
+    EXPECT_EQ("", value);
+    EXPECT_FALSE(testWrapper.testEnvGetValue("", value));
+
+    // A rewrite with a different size is picked up without restarting
+    {
+        std::ofstream out(propertiesFile, std::ofstream::trunc);
+        out << "MODEL_NUM=SKXI11ADS\n";
+    }
+    EXPECT_TRUE(testWrapper.testEnvGetValue("MODEL_NUM", value));
+    EXPECT_EQ("SKXI11ADS", value);
+    EXPECT_FALSE(testWrapper.testEnvGetValue("MFG_NAME", value));
+
+    // A missing file drops the cached values
+    remove(propertiesFile.c_str());
+    EXPECT_FALSE(testWrapper.testEnvGetValue("MODEL_NUM", value));
+    EXPECT_EQ("", value);
+
+    testWrapper.testSetDevicePropertiesFile("");
+}
+
+TEST(DynamicAppRegistryTest, resolveExactPrefixAndUnknown)
+{
+    DynamicAppRegistry registry;
+    registry.apps.push_back(std::make_shared<const DynamicAppConfig>("Netflix", "myNetflix", "", 1, "", ""));
+    registry.apps.push_back(std::make_shared<const DynamicAppConfig>("YouTube", "myYouTube", "", 1, "", ""));
+    registry.apps.push_back(std::make_shared<const DynamicAppConfig>("myYouTubeKids", "", "", 1, "", ""));
+    EXPECT_EQ(0u, registry.index.build(registry.apps));
+
+    const DynamicAppConfig* pApp = registry.resolve("Netflix");
+    ASSERT_NE(nullptr, pApp);
+    EXPECT_STREQ("Netflix", pApp->appName());
+
+    pApp = registry.resolve("myNetflixBeta");
+    ASSERT_NE(nullptr, pApp);
+    EXPECT_STREQ("Netflix", pApp->appName());
+
+    // Exact name wins over the shorter "myYouTube" prefix
+    pApp = registry.resolve("myYouTubeKids");
+    ASSERT_NE(nullptr, pApp);
+    EXPECT_STREQ("myYouTubeKids", pApp->appName());
+
+    // Case is ignored, like gdial's default app matching
+    pApp = registry.resolve("NETFLIX");
+    ASSERT_NE(nullptr, pApp);
+    EXPECT_STREQ("Netflix", pApp->appName());
+    pApp = registry.resolve("mynetflixbeta");
+    ASSERT_NE(nullptr, pApp);
+    EXPECT_STREQ("Netflix", pApp->appName());
+
+    EXPECT_EQ(nullptr, registry.resolve("Amazon"));
+    EXPECT_EQ(nullptr, registry.resolve("my"));
+}
+
+TEST(DynamicAppRegistryTest, packedConfigLayout)
+{
+    DynamicAppConfig full("Netflix", "myNetflix", ".netflix.com", 1, "source_type=12", "netflix_payload");
+    EXPECT_STREQ("Netflix", full.appName());
+    EXPECT_STREQ("myNetflix", full.prefixes());
+    EXPECT_STREQ(".netflix.com", full.cors());
+    EXPECT_EQ(1, full.allowStop());
+    EXPECT_STREQ("source_type=12", full.query());
+    EXPECT_STREQ("netflix_payload", full.payload());
+
+    // No query or payload: the cold block is not allocated and both read back empty
+    DynamicAppConfig hotOnly("Netflix", "myNetflix", ".netflix.com", 1, "", "");
+    EXPECT_STREQ("", hotOnly.query());
+    EXPECT_STREQ("", hotOnly.payload());
+    EXPECT_STREQ(".netflix.com", hotOnly.cors());
+    EXPECT_EQ(sizeof(DynamicAppConfig) + sizeof("Netflix") + sizeof("myNetflix") + sizeof(".netflix.com"), hotOnly.memoryUsage());
+    EXPECT_EQ(hotOnly.memoryUsage() + sizeof("source_type=12") + sizeof("netflix_payload"), full.memoryUsage());
+    EXPECT_LT(full.memoryUsage(), DynamicAppConfig::fixedLayoutMemoryUsage());
+
+    // Payload only still keeps an empty query in front of it
+    DynamicAppConfig payloadOnly("YouTube", "", "", 0, "", "youtube_payload");
+    EXPECT_STREQ("", payloadOnly.prefixes());
+    EXPECT_STREQ("", payloadOnly.query());
+    EXPECT_STREQ("youtube_payload", payloadOnly.payload());
+
+    // Oversized fields are truncated to their limits
+    DynamicAppConfig oversized(std::string(DYNAMIC_APP_MAX_NAME + 10, 'n'), std::string(DYNAMIC_APP_MAX_PREFIXES + 10, 'p'),
+                               std::string(DYNAMIC_APP_MAX_CORS + 10, 'c'), 0, std::string(DYNAMIC_APP_MAX_QUERY + 10, 'q'),
+                               std::string(DIAL_MAX_PAYLOAD + 10, 'd'));
+    EXPECT_EQ(static_cast<size_t>(DYNAMIC_APP_MAX_NAME), strlen(oversized.appName()));
+    EXPECT_EQ(static_cast<size_t>(DYNAMIC_APP_MAX_PREFIXES), strlen(oversized.prefixes()));
+    EXPECT_EQ(static_cast<size_t>(DYNAMIC_APP_MAX_CORS), strlen(oversized.cors()));
+    EXPECT_EQ(static_cast<size_t>(DYNAMIC_APP_MAX_QUERY), strlen(oversized.query()));
+    EXPECT_EQ(static_cast<size_t>(DIAL_MAX_PAYLOAD), strlen(oversized.payload()));
+    EXPECT_EQ(std::string(DYNAMIC_APP_MAX_CORS, 'c'), std::string(oversized.cors()));
+}
@@ -0,0 +1,63 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2024 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Module.h"
+#include "XCastCommon.h"
+#include <interfaces/IXCast.h>
+#include <list>
+#include <vector>
+
+namespace WPEFramework {
+namespace Plugin {
+
+    /*
+     * Dynamic app registry and gdial diagnostics calls that IXCast does not carry. IXCast comes from
+     * entservices-apis, which has no interface ID or proxy stub for these calls, so they are plain
+     * virtual calls on the XCastImplementation object rather than a COM-RPC interface.
+     *
+     * The XCast plugin finds them only when XCastImplementation runs inside the plugin process (root mode
+     * "Off"). In "Local" or "Container" mode the plugin holds a COM-RPC proxy for IXCast, finds no
+     * registry and does not register getRegisteredApplications, updateApplications or getGDialCallStats.
+     */
+    struct IXCastRegistry {
+        virtual ~IXCastRegistry() = default;
+
+        struct GDialCallStats {
+            string operation;
+            uint64_t calls;
+            uint64_t errors;
+            uint64_t totalMicros;
+            uint64_t maxMicros;
+            std::vector<uint64_t> histogram;           // calls per latency bucket
+            std::vector<uint64_t> bucketBoundsMicros;  // exclusive upper bound per bucket, one fewer than histogram (last is open ended)
+        };
+
+        // Pages through the registry; limit 0 returns everything from offset, fields is a DYNAMIC_APP_FIELD_* mask (0 for all)
+        virtual Core::hresult GetRegisteredApplications(const uint32_t offset, const uint32_t limit, const uint32_t fields, Exchange::IXCast::IApplicationInfoIterator*& appInfoList, uint32_t& total) = 0;
+        // Removes appsToRemove then adds or replaces appsToAdd (replaceAll starts from an empty registry); one registry change and one gdial push.
+        // Both sets travel as one JSON array text each: appsToAdd holds registerApplications objects, appsToRemove holds names; empty means none.
+        virtual Core::hresult UpdateApplications(const bool replaceAll, const string& appsToAdd, const string& appsToRemove, Exchange::IXCast::XCastSuccess& success) = 0;
+        // Calls made into gdialService per operation since activation; operations never called are left out
+        virtual Core::hresult GetGDialCallStats(std::list<GDialCallStats>& stats) = 0;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
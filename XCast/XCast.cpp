@@ -91,6 +91,18 @@ namespace WPEFramework
                         _xcast->Register(&_xcastNotification);
                         // Invoking Plugin API register to wpeframework
                         Exchange::JXCast::Register(*this, _xcast);
+                        // Only an in-process implementation ("Off" mode) is reachable this way, a COM-RPC proxy yields nullptr
+                        _registry = dynamic_cast<IXCastRegistry*>(_xcast);
+                        if (nullptr != _registry)
+                        {
+                            Register<JsonObject, JsonObject>(_T("getRegisteredApplications"), &XCast::getRegisteredApplications, this);
+                            Register<JsonObject, JsonObject>(_T("updateApplications"), &XCast::updateApplications, this);
+                            Register<JsonObject, JsonObject>(_T("getGDialCallStats"), &XCast::getGDialCallStats, this);
+                        }
+                        else
+                        {
+                            LOGWARN("XCastImpl runs out of process, registry methods are not available");
+                        }
                     }
                 }
                 else
@@ -123,6 +135,13 @@ namespace WPEFramework
             {
                 _xcast->Unregister(&_xcastNotification);
                 Exchange::JXCast::Unregister(*this);
+                if (nullptr != _registry)
+                {
+                    Unregister(_T("getRegisteredApplications"));
+                    Unregister(_T("updateApplications"));
+                    Unregister(_T("getGDialCallStats"));
+                    _registry = nullptr;
+                }
                 if (nullptr != mConfigure)
                 {
                     uint32_t result = mConfigure->Configure(nullptr);
@@ -171,6 +190,117 @@ namespace WPEFramework
             return ("This XCast Plugin facilitates to persist event data for monitoring applications");
         }
 
+        uint32_t XCast::getRegisteredApplications(const JsonObject& parameters, JsonObject& response)
+        {
+            const uint32_t offset = parameters.HasLabel("offset") ? static_cast<uint32_t>(parameters["offset"].Number()) : 0;
+            const uint32_t limit = parameters.HasLabel("limit") ? static_cast<uint32_t>(parameters["limit"].Number()) : 0;
+            const uint32_t requested = parameters.HasLabel("fields") ? static_cast<uint32_t>(parameters["fields"].Number()) : 0;
+            const uint32_t fields = ((0 == requested) ? DYNAMIC_APP_FIELD_ALL : (requested & DYNAMIC_APP_FIELD_ALL));
+            Exchange::IXCast::IApplicationInfoIterator* appInfoList = nullptr;
+            uint32_t total = 0;
+
+            uint32_t result = _registry->GetRegisteredApplications(offset, limit, fields, appInfoList, total);
+            if ((Core::ERROR_NONE == result) && (nullptr != appInfoList))
+            {
+                JsonArray applications;
+                Exchange::IXCast::ApplicationInfo appInfo;
+                while (appInfoList->Next(appInfo))
+                {
+                    // Only the requested keys, so a names-only page stays small
+                    JsonObject application;
+                    if (fields & DYNAMIC_APP_FIELD_NAME)
+                    {
+                        application["name"] = appInfo.appName;
+                    }
+                    if (fields & DYNAMIC_APP_FIELD_PREFIXES)
+                    {
+                        application["prefix"] = appInfo.prefixes;
+                    }
+                    if (fields & DYNAMIC_APP_FIELD_CORS)
+                    {
+                        application["cors"] = appInfo.cors;
+                    }
+                    if (fields & DYNAMIC_APP_FIELD_QUERY)
+                    {
+                        application["query"] = appInfo.query;
+                    }
+                    if (fields & DYNAMIC_APP_FIELD_PAYLOAD)
+                    {
+                        application["payload"] = appInfo.payload;
+                    }
+                    if (fields & DYNAMIC_APP_FIELD_ALLOW_STOP)
+                    {
+                        application["allowStop"] = appInfo.allowStop;
+                    }
+                    applications.Add(application);
+                }
+                appInfoList->Release();
+                response["applications"] = applications;
+                response["total"] = total;
+            }
+            response["success"] = (Core::ERROR_NONE == result);
+            return result;
+        }
+
+        uint32_t XCast::getGDialCallStats(const JsonObject& parameters, JsonObject& response)
+        {
+            std::list<IXCastRegistry::GDialCallStats> callStats;
+
+            uint32_t result = _registry->GetGDialCallStats(callStats);
+            if (Core::ERROR_NONE == result)
+            {
+                JsonArray stats;
+                for (const IXCastRegistry::GDialCallStats& entry : callStats)
+                {
+                    JsonObject operation;
+                    operation["operation"] = entry.operation;
+                    operation["calls"] = entry.calls;
+                    operation["errors"] = entry.errors;
+                    operation["totalMicros"] = entry.totalMicros;
+                    operation["maxMicros"] = entry.maxMicros;
+                    JsonArray histogram;
+                    for (uint64_t count : entry.histogram)
+                    {
+                        histogram.Add(JsonValue(count));
+                    }
+                    operation["histogram"] = histogram;
+                    JsonArray bucketBounds;
+                    for (uint64_t bound : entry.bucketBoundsMicros)
+                    {
+                        bucketBounds.Add(JsonValue(bound));
+                    }
+                    operation["bucketBoundsMicros"] = bucketBounds;
+                    stats.Add(operation);
+                }
+                response["stats"] = stats;
+            }
+            response["success"] = (Core::ERROR_NONE == result);
+            return result;
+        }
+
+        uint32_t XCast::updateApplications(const JsonObject& parameters, JsonObject& response)
+        {
+            const bool replaceAll = parameters.HasLabel("replaceAll") && parameters["replaceAll"].Boolean();
+            string appsToAdd;
+            string appsToRemove;
+
+            // Both arrays go over as their JSON text, parsed once by the implementation
+            if (parameters.HasLabel("applications"))
+            {
+                parameters["applications"].ToString(appsToAdd);
+            }
+            if (parameters.HasLabel("remove"))
+            {
+                parameters["remove"].ToString(appsToRemove);
+            }
+
+            Exchange::IXCast::XCastSuccess success;
+            success.success = false;
+            uint32_t result = _registry->UpdateApplications(replaceAll, appsToAdd, appsToRemove, success);
+            response["success"] = success.success;
+            return result;
+        }
+
         void XCast::Deactivated(RPC::IRemoteConnection *connection)
         {
             if (connection->Id() == _connectionId)
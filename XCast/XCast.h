@@ -36,6 +36,7 @@
 #include <interfaces/json/JsonData_XCast.h>
 #include <interfaces/json/JXCast.h>
 #include <interfaces/IConfiguration.h>
+#include "IXCastRegistry.h"
 #include "UtilsLogging.h"
 #include "tracing/Logging.h"
 
@@ -144,12 +145,18 @@ namespace WPEFramework {
 				
 				private:
                 	void Deactivated(RPC::IRemoteConnection* connection);
+					// JSON-RPC for IXCastRegistry, registered only when the implementation runs in this process
+					uint32_t getRegisteredApplications(const JsonObject& parameters, JsonObject& response);
+					uint32_t updateApplications(const JsonObject& parameters, JsonObject& response);
+					uint32_t getGDialCallStats(const JsonObject& parameters, JsonObject& response);
 			
 				private:
 					PluginHost::IShell *_service{};
 					uint32_t _connectionId{};
 					Exchange::IXCast *_xcast{};
 					Exchange::IConfiguration* mConfigure;
+					// Same object as _xcast, not reference counted on its own
+					IXCastRegistry* _registry{};
 					Core::Sink<Notification> _xcastNotification;
 
 					friend class Notification;
@@ -18,7 +18,13 @@
  **/
 
 #include <iostream>
+#include <cctype>
 #include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
 
 #ifndef __XCAST_COMMON_H__
 #define __XCAST_COMMON_H__
@@ -28,23 +34,250 @@
  */
 #define DIAL_MAX_PAYLOAD (4096*3)
 
+/*
+ * Maximum lengths (excluding the terminator) accepted for the registered
+ * application fields. Longer values are truncated.
+ */
+#define DYNAMIC_APP_MAX_NAME     (63)
+#define DYNAMIC_APP_MAX_PREFIXES (127)
+#define DYNAMIC_APP_MAX_CORS     (127)
+#define DYNAMIC_APP_MAX_QUERY    (2047)
+
+/*
+ * Field mask for GetRegisteredApplications. The name is always returned;
+ * a mask of 0 selects every field.
+ */
+#define DYNAMIC_APP_FIELD_NAME       (0x01)
+#define DYNAMIC_APP_FIELD_PREFIXES   (0x02)
+#define DYNAMIC_APP_FIELD_CORS       (0x04)
+#define DYNAMIC_APP_FIELD_ALLOW_STOP (0x08)
+#define DYNAMIC_APP_FIELD_QUERY      (0x10)
+#define DYNAMIC_APP_FIELD_PAYLOAD    (0x20)
+#define DYNAMIC_APP_FIELD_ALL        (0x3F)
+
+/*
+ * Dynamically registered application.
+ * The fields sent to gdial (name, prefixes, cors, allowStop) are packed into a
+ * single exact-size block. query and payload are only kept for diagnostics, so
+ * they live in a separate block that is allocated only when one is non-empty.
+ */
+class DynamicAppConfig
+{
+public:
+    DynamicAppConfig(const std::string& appName, const std::string& prefixes, const std::string& cors,
+                     int allowStop, const std::string& query, const std::string& payload)
+        : m_allowStop(allowStop)
+    {
+        size_t nameLen = clamp(appName, DYNAMIC_APP_MAX_NAME);
+        size_t prefixesLen = clamp(prefixes, DYNAMIC_APP_MAX_PREFIXES);
+        size_t corsLen = clamp(cors, DYNAMIC_APP_MAX_CORS);
+
+        m_prefixesOffset = nameLen + 1;
+        m_corsOffset = m_prefixesOffset + prefixesLen + 1;
+        m_hotSize = m_corsOffset + corsLen + 1;
+        m_hot.reset(new char[m_hotSize]);
+        pack(m_hot.get(), appName, nameLen);
+        pack(m_hot.get() + m_prefixesOffset, prefixes, prefixesLen);
+        pack(m_hot.get() + m_corsOffset, cors, corsLen);
+
+        size_t queryLen = clamp(query, DYNAMIC_APP_MAX_QUERY);
+        size_t payloadLen = clamp(payload, DIAL_MAX_PAYLOAD);
+
+        m_payloadOffset = queryLen + 1;
+        m_coldSize = 0;
+        if ((0 != queryLen) || (0 != payloadLen))
+        {
+            m_coldSize = m_payloadOffset + payloadLen + 1;
+            m_cold.reset(new char[m_coldSize]);
+            pack(m_cold.get(), query, queryLen);
+            pack(m_cold.get() + m_payloadOffset, payload, payloadLen);
+        }
+    }
+
+    DynamicAppConfig(const DynamicAppConfig&) = delete;
+    DynamicAppConfig& operator=(const DynamicAppConfig&) = delete;
+
+    const char* appName() const { return m_hot.get(); }
+    const char* prefixes() const { return m_hot.get() + m_prefixesOffset; }
+    const char* cors() const { return m_hot.get() + m_corsOffset; }
+    int allowStop() const { return m_allowStop; }
+    const char* query() const { return m_cold ? m_cold.get() : ""; }
+    const char* payload() const { return m_cold ? m_cold.get() + m_payloadOffset : ""; }
+
+    /* Bytes used by this entry: the object plus its string blocks. */
+    size_t memoryUsage() const
+    {
+        return sizeof(*this) + m_hotSize + m_coldSize;
+    }
+
+    /* Bytes a single entry used with the former fixed-size layout. */
+    static size_t fixedLayoutMemoryUsage()
+    {
+        return (DYNAMIC_APP_MAX_NAME + 1) + (DYNAMIC_APP_MAX_PREFIXES + 1) + (DYNAMIC_APP_MAX_CORS + 1) +
+               sizeof(int) + (DYNAMIC_APP_MAX_QUERY + 1) + (DIAL_MAX_PAYLOAD + 1);
+    }
+
+private:
+    static size_t clamp(const std::string& value, size_t maxLen)
+    {
+        return (value.size() > maxLen) ? maxLen : value.size();
+    }
+
+    static void pack(char* dest, const std::string& value, size_t length)
+    {
+        memcpy(dest, value.data(), length);
+        dest[length] = '\0';
+    }
+
+    std::unique_ptr<char[]> m_hot;
+    std::unique_ptr<char[]> m_cold;
+    size_t m_prefixesOffset;
+    size_t m_corsOffset;
+    size_t m_hotSize;
+    size_t m_payloadOffset;
+    size_t m_coldSize;
+    int m_allowStop;
+};
+
+typedef std::vector<std::shared_ptr<const DynamicAppConfig>> DynamicAppConfigList;
+
+/*
+ * Compiled prefix trie over the names and prefixes of a registry snapshot.
+ * Resolves an application name to the index of the owning registration in
+ * O(length). An exact name match wins over the longest matching prefix.
+ * Matching ignores case, like gdial's own lookup of the default apps.
+ */
+class DynamicAppIndex
+{
+public:
+    static const int NO_OWNER = -1;
+
+    /* Returns the number of names or prefixes already claimed by an earlier entry. */
+    size_t build(const DynamicAppConfigList& apps)
+    {
+        size_t conflicts = 0;
+        m_nodes.clear();
+        m_nodes.emplace_back();
+        for (size_t owner = 0; owner < apps.size(); ++owner)
+        {
+            conflicts += insert(apps[owner]->appName(), owner, true) ? 0 : 1;
+
+            //prefixes may carry several entries separated by ',' or ';'
+            std::string prefix;
+            for (const char* c = apps[owner]->prefixes(); ; ++c)
+            {
+                if (('\0' == *c) || (',' == *c) || (';' == *c))
+                {
+                    if (!prefix.empty())
+                    {
+                        conflicts += insert(prefix, owner, false) ? 0 : 1;
+                        prefix.clear();
+                    }
+                    if ('\0' == *c)
+                    {
+                        break;
+                    }
+                }
+                else if (' ' != *c)
+                {
+                    prefix += *c;
+                }
+            }
+        }
+        return conflicts;
+    }
+
+    int resolve(const std::string& appName) const
+    {
+        if (m_nodes.empty())
+        {
+            return NO_OWNER;
+        }
+        uint32_t node = 0;
+        int owner = NO_OWNER;
+        for (char c : appName)
+        {
+            node = child(node, fold(c));
+            if (0 == node)
+            {
+                return owner;
+            }
+            if (NO_OWNER != m_nodes[node].prefixOwner)
+            {
+                owner = m_nodes[node].prefixOwner;
+            }
+        }
+        return (NO_OWNER != m_nodes[node].exactOwner) ? m_nodes[node].exactOwner : owner;
+    }
+
+private:
+    struct Node
+    {
+        std::vector<std::pair<char, uint32_t>> children; //sorted by character
+        int exactOwner = NO_OWNER;
+        int prefixOwner = NO_OWNER;
+    };
+
+    static char fold(char c)
+    {
+        return (char)std::tolower((unsigned char)c);
+    }
+
+    //The root is never a child, so 0 means no such child.
+    uint32_t child(uint32_t node, char c) const
+    {
+        const std::vector<std::pair<char, uint32_t>>& children = m_nodes[node].children;
+        auto itr = std::lower_bound(children.begin(), children.end(), std::make_pair(c, (uint32_t)0));
+        return ((itr != children.end()) && (itr->first == c)) ? itr->second : 0;
+    }
+
+    bool insert(const std::string& key, size_t owner, bool exact)
+    {
+        uint32_t node = 0;
+        for (char k : key)
+        {
+            const char c = fold(k);
+            uint32_t next = child(node, c);
+            if (0 == next)
+            {
+                next = (uint32_t)m_nodes.size();
+                m_nodes.emplace_back();
+                std::vector<std::pair<char, uint32_t>>& children = m_nodes[node].children;
+                children.insert(std::lower_bound(children.begin(), children.end(), std::make_pair(c, (uint32_t)0)),
+                                std::make_pair(c, next));
+            }
+            node = next;
+        }
+        int& slot = exact ? m_nodes[node].exactOwner : m_nodes[node].prefixOwner;
+        if (NO_OWNER != slot)
+        {
+            return false;
+        }
+        slot = (int)owner;
+        return true;
+    }
+
+    std::vector<Node> m_nodes;
+};
+
+/*
+ * Immutable view of the registered applications. Writers publish a new
+ * instance for every change; readers keep the one they loaded for as long
+ * as they need it without holding any lock.
+ */
+struct DynamicAppRegistry
+{
+    uint64_t generation = 0; //0 means nothing was ever registered
+    DynamicAppConfigList apps;
+    DynamicAppIndex index;   //built from apps before the snapshot is published
 
-typedef struct _DynamicAppConfig {
-    char appName[64];
-    char prefixes[128];
-    char cors[128];
-    int  allowStop = 0; //Default allowStop value is false
-    char query[2048];
-    char payload[DIAL_MAX_PAYLOAD+1];
-
-    public:
-       _DynamicAppConfig(){
-           memset (appName, '\0', sizeof(appName));
-           memset (prefixes, '\0', sizeof(prefixes));
-           memset (cors, '\0', sizeof(cors));
-           memset (query, '\0', sizeof(query));
-           memset (payload, '\0', sizeof(payload));
-       }
-}DynamicAppConfig;
+    /* Owning registration of appName, or nullptr when no name or prefix matches. */
+    const DynamicAppConfig* resolve(const std::string& appName) const
+    {
+        int owner = index.resolve(appName);
+        return (DynamicAppIndex::NO_OWNER != owner) ? apps[owner].get() : nullptr;
+    }
+};
+typedef std::shared_ptr<const DynamicAppRegistry> DynamicAppRegistryPtr;
 
 #endif
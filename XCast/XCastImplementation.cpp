@@ -26,6 +26,8 @@
 #include "rfcapi.h"
 #include <string>
 #include <vector>
+#include <sstream>
+#include <fnmatch.h>
 
 #define SERVER_DETAILS "127.0.0.1:9998"
 #define THUNDER_RPC_TIMEOUT 5000
@@ -46,10 +48,16 @@ namespace WPEFramework
         SERVICE_REGISTRATION(XCastImplementation, 1, 0);
         XCastImplementation *XCastImplementation::_instance = nullptr;
         XCastManager* XCastImplementation::m_xcast_manager = nullptr;
-        static std::vector <DynamicAppConfig*> m_appConfigCache;
+        //Published with std::atomic_store, read with std::atomic_load
+        static DynamicAppRegistryPtr m_appConfigCache = std::make_shared<const DynamicAppRegistry>();
+        //Serializes writers of m_appConfigCache only, never held across gdial calls
         static std::mutex m_appConfigMutex;
         static std::mutex m_TimerMutexSync;
+        //Set under m_TimerMutexSync before deactivation joins the gdial liveness and RFC threads
+        static std::atomic<bool> m_isDeactivating{false};
         static bool xcastEnableCache = false;
+        //Set when the cast service state changed while gdial was still being initialized
+        static std::atomic<bool> m_activationPending{false};
 
         #ifdef XCAST_ENABLED_BY_DEFAULT
         bool XCastImplementation::m_xcastEnable = true;
@@ -70,10 +78,16 @@ namespace WPEFramework
 
         static string friendlyNameCache = "Living Room";
         static string m_activeInterfaceName = "";
-        static bool m_isDynamicRegistrationsRequired = false;
+        //Interface and address gdial is currently advertising on
+        static std::mutex m_boundInterfaceMutex;
+        static string m_boundInterface = "";
+        static string m_boundIPAddress = "";
 
         static bool m_is_restart_req = false;
 
+        //Interface name pattern to transport type, first match wins; filled in Configure before any network event
+        static std::vector<std::pair<string, string>> m_interfaceTypeRules;
+
         XCastImplementation::XCastImplementation()
         : _service(nullptr),
         _pwrMgrNotification(*this),
@@ -157,7 +171,12 @@ namespace WPEFramework
                 if(nullptr != m_xcast_manager)
                 {
                     m_xcast_manager->setService(this);
-                    if( false == connectToGDialService())
+                    //gdial arguments derived from RFC changed, restart it with the new ones
+                    m_xcast_manager->setRFCChangeCallback([this]() { warmRestartGDialService(); });
+                    //Reconnect as soon as gdial stops answering instead of waiting for a network event
+                    m_xcast_manager->setGDialLostCallback([this]() { warmRestartGDialService(); });
+                    //Activation does not wait for gdial, the result arrives in onGDialServiceConnected
+                    if( false == connectToGDialService(GDIAL_CONNECT_ACTIVATION))
                     {
                         startTimer(LOCATE_CAST_FIRST_TIMEOUT_IN_MILLIS);
                     }
@@ -175,6 +194,8 @@ namespace WPEFramework
             LOGINFO("Entering..!!!");
             if(nullptr != m_xcast_manager)
             {
+                //No completion callback may restart the timer once it is stopped
+                m_xcast_manager->cancelInitialize();
                 stopTimer();
                 m_xcast_manager->shutdown();
                 m_xcast_manager = nullptr;
@@ -207,6 +228,10 @@ namespace WPEFramework
                 }
                 updateNWConnectivityStatus(interface.c_str(), isAcquired, ipaddress.c_str());
             }
+            else if (("IPv4" == ipversion) && (Exchange::INetworkManager::IP_LOST == status))
+            {
+                updateNWConnectivityStatus(interface.c_str(), false);
+            }
         }
 
         void XCastImplementation::getSystemPlugin()
@@ -280,13 +305,8 @@ namespace WPEFramework
 
         void XCastImplementation::threadSystemFriendlyNameChangeEvent(void)
         {
-            bool enabledStatus = false;
-            if (m_xcastEnable && ( (m_standbyBehavior == true) || ((m_standbyBehavior == false)&&(m_powerState == WPEFramework::Exchange::IPowerManager::POWER_STATE_ON))))
-            {
-                enabledStatus = true;
-            }
-            LOGINFO("Updating FriendlyName from Timer [%s] status[%x]",m_friendlyName.c_str(),enabledStatus);
-            enableCastService(m_friendlyName,enabledStatus);
+            LOGINFO("Updating FriendlyName from Timer [%s]",m_friendlyName.c_str());
+            updateCastAvailability();
         }
 
         uint32_t XCastImplementation::Configure(PluginHost::IShell* service)
@@ -295,6 +315,8 @@ namespace WPEFramework
             if (( nullptr == _service ) && (service))
             {
                 LOGINFO("Call initialise()");
+                m_isDeactivating = false;
+                loadInterfaceTypeRules(service);
                 _service = service;
                 _service->AddRef();
                 InitializePowerManager(service);
@@ -309,7 +331,11 @@ namespace WPEFramework
             }
             else if ((_service) && ( nullptr == service ))
             {
-                lock_guard<mutex> lck(m_TimerMutexSync);
+                {
+                    //Not held across Deinitialize: shutdown() joins threads that may be waiting for it
+                    lock_guard<mutex> lck(m_TimerMutexSync);
+                    m_isDeactivating = true;
+                }
                 LOGINFO("Call deinitialise()");
                 Deinitialize();
                 _service->Release();
@@ -441,9 +467,7 @@ namespace WPEFramework
             {
                 if (m_is_restart_req)
                 {
-                    Deinitialize();
-                    sleep(1);
-                    Initialize(m_networkStandbyMode);
+                    warmRestartGDialService();
                     m_is_restart_req = false;
                 }
             }
@@ -452,16 +476,8 @@ namespace WPEFramework
                 m_is_restart_req = true; //After DEEPSLEEP, restart xdial again for next transition.
             }
 
-            if(m_standbyBehavior == false)
-            {
-                bool enabledStatus = false;
-                LOGINFO("m_xcastEnable:[%u] , m_powerState:[%d] ",m_xcastEnable,m_powerState);
-                if(m_xcastEnable && ( m_powerState == WPEFramework::Exchange::IPowerManager::POWER_STATE_ON))
-                {
-                    enabledStatus = true;
-                }
-                enableCastService(m_friendlyName, enabledStatus);
-            }
+            LOGINFO("m_xcastEnable:[%u] , m_powerState:[%d] ",m_xcastEnable,m_powerState);
+            updateCastAvailability();
             powerModeChangeActive = false;
         }
 
@@ -475,6 +491,10 @@ namespace WPEFramework
         {
             LOGINFO("[EVENT] appName[%s], strPayLoad[%s], strQuery[%s], strAddDataUrl[%s]",
                     appName.c_str(),strPayLoad.c_str(),strQuery.c_str(),strAddDataUrl.c_str());
+            if (!isKnownApplication(appName))
+            {
+                return;
+            }
             JsonObject params;
             params["appName"]  = appName.c_str();
             params["strPayLoad"]  = strPayLoad.c_str();
@@ -486,6 +506,10 @@ namespace WPEFramework
         void XCastImplementation::onXcastApplicationLaunchRequest(string appName, string parameter)
         {
             LOGINFO("[EVENT] appName[%s], parameter[%s]",appName.c_str(),parameter.c_str());
+            if (!isKnownApplication(appName))
+            {
+                return;
+            }
             JsonObject params;
             params["appName"]  = appName.c_str();
             params["parameter"]  = parameter.c_str();
@@ -536,37 +560,231 @@ namespace WPEFramework
             setPowerState(powerState);
         }
 
-        bool XCastImplementation::connectToGDialService(void)
+        bool XCastImplementation::connectToGDialService(GDialConnectReason reason)
         {
             LOGINFO("Entering ...");
             std::string interface,ipaddress;
             bool status = false;
 
-            if (_service == nullptr) {
+            if ((_service == nullptr) || (nullptr == m_xcast_manager)) {
                 LOGERR("Service is not initialized");
                 return false;
             }
 
+            auto requested = std::chrono::steady_clock::now();
             getDefaultNameAndIPAddress(interface,ipaddress);
             if (!interface.empty())
             {
-                status = m_xcast_manager->initialize(_service, interface, m_networkStandbyMode);
-                if( true == status)
+                string interfaceType = getInterfaceNameToType(interface);
+                status = m_xcast_manager->initializeAsync(_service, interface, interfaceType, m_networkStandbyMode,
+                                                          [this, interface, ipaddress, interfaceType, reason, requested](bool connected) {
+                                                              if (connected)
+                                                              {
+                                                                  //gdial picks its own -I, which need not be the primary interface
+                                                                  string gdialInterface = m_xcast_manager->getGDialInterface();
+                                                                  string gdialIPAddress = ipaddress;
+                                                                  if (gdialInterface != interface)
+                                                                  {
+                                                                      gdialIPAddress.clear();
+                                                                      getInterfaceIPAddress(gdialInterface, gdialIPAddress);
+                                                                  }
+                                                                  LOGINFO("GDialService bound to IF[%s]IP[%s]",gdialInterface.c_str(),gdialIPAddress.c_str());
+                                                                  lock_guard<mutex> lck(m_boundInterfaceMutex);
+                                                                  m_boundInterface = gdialInterface;
+                                                                  m_boundIPAddress = gdialIPAddress;
+                                                              }
+                                                              onGDialServiceConnected(connected, interfaceType, reason, requested);
+                                                          });
+            }
+            LOGINFO("GDialService initialize started[%u]IF[%s]IP[%s]",status,interface.c_str(),ipaddress.c_str());
+            LOGINFO("Exiting ...");
+            return status;
+        }
+
+        void XCastImplementation::onGDialServiceConnected(bool status, const string& interfaceType, GDialConnectReason reason, std::chrono::steady_clock::time_point requested)
+        {
+            LOGINFO("GDialService[%u]IF[%s]reason[%d]", status, interfaceType.c_str(), reason);
+            if (false == status)
+            {
+                if (GDIAL_CONNECT_TIMER == reason)
+                {
+                    LOGINFO("Retry after 10 sec...");
+                    m_locateCastTimer.setInterval(LOCATE_CAST_SECOND_TIMEOUT_IN_MILLIS);
+                }
+                else
+                {
+                    startTimer(LOCATE_CAST_FIRST_TIMEOUT_IN_MILLIS);
+                }
+                return;
+            }
+
+            m_activeInterfaceName = interfaceType;
+            if (GDIAL_CONNECT_TIMER == reason)
+            {
+                stopTimer();
+            }
+            if (nullptr == m_xcast_manager)
+            {
+                return;
+            }
+
+            //Re-push only when this gdial instance has not acknowledged the current registry; on activation
+            //this picks up registrations made while gdial was still starting
+            DynamicAppRegistryPtr appRegistry = std::atomic_load(&m_appConfigCache);
+            uint64_t registeredGeneration = m_xcast_manager->getRegisteredAppsGeneration();
+            LOGINFO("AppConfig generation[%llu] gdial generation[%llu]",
+                    (unsigned long long)appRegistry->generation, (unsigned long long)registeredGeneration);
+            if (appRegistry->generation != registeredGeneration)
+            {
+                LOGINFO("> calling registerApplications with [%d] cached apps", (int)appRegistry->apps.size());
+                m_xcast_manager->registerApplications (appRegistry);
+            }
+
+            uint64_t generation = 0;
+            {
+                lock_guard<mutex> lck(m_castOutputMutex);
+                if (GDIAL_CONNECT_ACTIVATION == reason)
+                {
+                    //Replay a state change that reached the manager before gdial was up
+                    if (m_activationPending.exchange(false))
+                    {
+                        m_castOutputApplied = true;
+                        generation = ++m_castOutputGeneration;
+                    }
+                }
+                else
                 {
-                    m_activeInterfaceName = getInterfaceNameToType(interface);
+                    //A fresh gdial instance knows nothing yet, push the last output unconditionally
+                    m_activationPending = false;
+                    m_castOutputApplied = true;
+                    generation = ++m_castOutputGeneration;
                 }
             }
-            LOGINFO("GDialService[%u]IF[%s]IP[%s]",status,interface.c_str(),ipaddress.c_str());
+            if (0 != generation)
+            {
+                pushCastOutput(generation);
+            }
+            LOGINFO("GDialService ready in [%lld] ms, reason[%d]",
+                    (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - requested).count(), reason);
+        }
+
+        void XCastImplementation::warmRestartGDialService(void)
+        {
+            LOGINFO("Entering ...");
+            lock_guard<mutex> lck(m_TimerMutexSync);
+            if (m_isDeactivating)
+            {
+                LOGWARN("Plugin is deactivating, GDialService not restarted");
+                return;
+            }
+            if (nullptr == m_xcast_manager)
+            {
+                LOGERR("XCastManager is not initialized");
+                return;
+            }
+            stopTimer();
+            //Only the gdial instance goes; identity, configuration and the app registry stay cached
+            m_xcast_manager->deinitialize();
+            if (false == connectToGDialService(GDIAL_CONNECT_WARM_RESTART))
+            {
+                startTimer(LOCATE_CAST_FIRST_TIMEOUT_IN_MILLIS);
+            }
             LOGINFO("Exiting ...");
-            return status;
+        }
+
+        bool XCastImplementation::isBoundInterfaceServing(const std::string& nwInterface, const std::string& ipaddress)
+        {
+            string boundInterface, boundIPAddress;
+            {
+                lock_guard<mutex> lck(m_boundInterfaceMutex);
+                boundInterface = m_boundInterface;
+                boundIPAddress = m_boundIPAddress;
+            }
+            if (boundInterface.empty() || boundIPAddress.empty() ||
+                (nullptr == m_xcast_manager) || (0 == m_xcast_manager->isGDialStarted()))
+            {
+                return false;
+            }
+            if (nwInterface == boundInterface)
+            {
+                //Same interface re-announced; rebind only if its address moved
+                return (ipaddress.empty() || (ipaddress == boundIPAddress));
+            }
+            //Another interface became primary; keep serving while the bound one still holds its address
+            string currentIPAddress;
+            return (getInterfaceIPAddress(boundInterface, currentIPAddress) && (currentIPAddress == boundIPAddress));
+        }
+
+        bool XCastImplementation::getInterfaceIPAddress(const std::string& nwInterface, std::string& ipaddress)
+        {
+            if (nwInterface.empty() || (nullptr == _networkManagerPlugin))
+            {
+                return false;
+            }
+            Exchange::INetworkManager::IPAddress address{};
+            string queryInterface = nwInterface;
+            uint32_t rc = _networkManagerPlugin->GetIPSettings(queryInterface, "IPv4", address);
+            if (Core::ERROR_NONE != rc)
+            {
+                LOGERR("Failed to get IP Settings of [%s] from NM: %u",nwInterface.c_str(),rc);
+                return false;
+            }
+            ipaddress = address.ipaddress;
+            return !ipaddress.empty();
+        }
+
+        void XCastImplementation::parseInterfaceTypeRules(const string& rules)
+        {
+            //"pattern:TYPE" entries separated by ',', e.g. "eth*:ETHERNET,wlan*:WIFI,moca*:MOCA"
+            std::istringstream ruleStream(rules);
+            string rule;
+            while (std::getline(ruleStream, rule, ','))
+            {
+                rule.erase(0, rule.find_first_not_of(" \t"));
+                rule.erase(rule.find_last_not_of(" \t") + 1);
+                if (rule.empty())
+                {
+                    continue;
+                }
+                string::size_type delimpos = rule.find(':');
+                if ((string::npos == delimpos) || (0 == delimpos) || ((rule.size() - 1) == delimpos))
+                {
+                    LOGWARN("Ignoring interface type rule [%s]", rule.c_str());
+                    continue;
+                }
+                m_interfaceTypeRules.emplace_back(rule.substr(0, delimpos), rule.substr(delimpos + 1));
+            }
+        }
+
+        void XCastImplementation::loadInterfaceTypeRules(PluginHost::IShell* service)
+        {
+            string rules;
+            JsonObject config;
+            m_interfaceTypeRules.clear();
+            if ((nullptr != service) && config.FromString(service->ConfigLine()) && config.HasLabel("interfacetypes"))
+            {
+                rules = config["interfacetypes"].String();
+            }
+            if (rules.empty() && (nullptr != XCastManager::getInstance()))
+            {
+                XCastManager::getInstance()->getInterfaceTypeRules(rules);
+            }
+            parseInterfaceTypeRules(rules);
+            //Built-in rules come last so configured ones can override them; they only cover the interfaces gdial is bound to by name
+            m_interfaceTypeRules.emplace_back("eth0", "ETHERNET");
+            m_interfaceTypeRules.emplace_back("wlan0", "WIFI");
+            LOGINFO("[%d] interface type rules, configured[%s]", (int)m_interfaceTypeRules.size(), rules.c_str());
         }
 
         string XCastImplementation::getInterfaceNameToType(const string & interface)
         {
-            if(interface == "wlan0")
-                return string("WIFI");
-            else if(interface == "eth0")
-                return string("ETHERNET");
+            for (const auto& rule : m_interfaceTypeRules)
+            {
+                if (0 == fnmatch(rule.first.c_str(), interface.c_str(), 0))
+                {
+                    return rule.second;
+                }
+            }
             return string("");
         }
 
@@ -643,27 +861,54 @@ namespace WPEFramework
             LOGINFO("Interface[%s]Mapped[%s] Connected[%u] IP[%s]",nwInterface.c_str(),mappedInterface.c_str(),nwConnected,ipaddress.c_str());
             if(nwConnected)
             {
-                if(mappedInterface.compare("ETHERNET")==0){
-                    LOGINFO("Connectivity type Ethernet");
-                    status = true;
-                }
-                else if(mappedInterface.compare("WIFI")==0){
-                    LOGINFO("Connectivity type WIFI");
+                if(!mappedInterface.empty()){
+                    LOGINFO("Connectivity type %s", mappedInterface.c_str());
                     status = true;
                 }
                 else{
-                    LOGERR("Connectivity type Unknown");
+                    //gdial's -I (e.g. the MoCA interface) need not map to a type, its address moving still needs a rebind
+                    lock_guard<mutex> lck(m_boundInterfaceMutex);
+                    status = (!m_boundInterface.empty() && (nwInterface == m_boundInterface));
+                    if (!status)
+                    {
+                        LOGERR("Connectivity type Unknown");
+                    }
                 }
             }
             else
             {
+                bool isBound = false;
+                {
+                    lock_guard<mutex> lck(m_boundInterfaceMutex);
+                    isBound = (!m_boundInterface.empty() && (nwInterface == m_boundInterface));
+                    if (isBound)
+                    {
+                        m_boundInterface.clear();
+                        m_boundIPAddress.clear();
+                    }
+                }
+                if (isBound && !m_locateCastTimer.isActive())
+                {
+                    //The interface gdial advertises on is gone, fail over to the current primary
+                    LOGWARN("Bound interface [%s] lost its address, rebinding GDialService", nwInterface.c_str());
+                    if (m_xcast_manager)
+                    {
+                        m_xcast_manager->deinitialize();
+                    }
+                    startTimer(LOCATE_CAST_FIRST_TIMEOUT_IN_MILLIS);
+                    return;
+                }
                 LOGERR("Connectivity type Unknown");
             }
             if (!m_locateCastTimer.isActive())
             {
                 if (status)
                 {
-                    if ((0 != mappedInterface.compare(m_activeInterfaceName)) ||
+                    if (isBoundInterfaceServing(nwInterface, ipaddress))
+                    {
+                        LOGINFO("GDialService stays on [%s], no rebind required", nwInterface.c_str());
+                    }
+                    else if ((0 != mappedInterface.compare(m_activeInterfaceName)) ||
                         ((0 == mappedInterface.compare(m_activeInterfaceName)) && !ipaddress.empty()))
                     {
                         if (m_xcast_manager)
@@ -683,44 +928,81 @@ namespace WPEFramework
             LOGINFO("Timer Entrying ...");
             {
                 lock_guard<mutex> lck(m_TimerMutexSync);
-                if( false == connectToGDialService())
+                if (m_isDeactivating)
+                {
+                    LOGINFO("Plugin is deactivating");
+                }
+                else if ((nullptr != m_xcast_manager) && m_xcast_manager->isInitializePending())
+                {
+                    LOGINFO("gdial initialize still in progress");
+                }
+                else if( false == connectToGDialService(GDIAL_CONNECT_TIMER))
                 {
                     LOGINFO("Retry after 10 sec...");
                     m_locateCastTimer.setInterval(LOCATE_CAST_SECOND_TIMEOUT_IN_MILLIS);
-                    LOGINFO("Timer Exiting ...");
-                    return ;
                 }
-                stopTimer();
             }
+            LOGINFO("Timer still active ? %d ",m_locateCastTimer.isActive());
+            LOGINFO("Timer Exiting ...");
+        }
 
-            if (nullptr != m_xcast_manager)
+        bool XCastImplementation::isCastServiceActive(void)
+        {
+            return (m_xcastEnable && (m_standbyBehavior || (m_powerState == WPEFramework::Exchange::IPowerManager::POWER_STATE_ON)));
+        }
+
+        void XCastImplementation::updateCastAvailability(bool onlyIfApplied)
+        {
+            bool active = isCastServiceActive();
+            string friendlyName = m_friendlyName;
+            uint64_t generation = 0;
             {
-                LOGINFO("isDynamicRegistrationsRequired[%u]",m_isDynamicRegistrationsRequired);
-                if (m_isDynamicRegistrationsRequired)
+                //Only the edge is decided here, gdial is called after the lock is released
+                lock_guard<mutex> lck(m_castOutputMutex);
+                if (!m_castOutputApplied && onlyIfApplied)
                 {
-                    std::vector<DynamicAppConfig*> appConfigList;
-                    lock_guard<mutex> lck(m_appConfigMutex);
-                    appConfigList = m_appConfigCache;
-                    dumpDynamicAppCacheList(string("CachedAppsFromTimer"), appConfigList);
-                    LOGINFO("> calling registerApplications");
-                    m_xcast_manager->registerApplications (appConfigList);
+                    return;
                 }
-                m_xcast_manager->enableCastService(friendlyNameCache,xcastEnableCache);
+                if (m_castOutputApplied && (active == xcastEnableCache) && (friendlyName == friendlyNameCache))
+                {
+                    ++m_castOutputSkipped;
+                    LOGINFO("Cast availability unchanged active[%d] friendlyname[%s], skipped[%llu]",
+                            active, friendlyName.c_str(), (unsigned long long)m_castOutputSkipped);
+                    return;
+                }
+                m_castOutputApplied = true;
+                xcastEnableCache = active;
+                friendlyNameCache = std::move(friendlyName);
+                generation = ++m_castOutputGeneration;
             }
-            LOGINFO("Timer still active ? %d ",m_locateCastTimer.isActive());
-            LOGINFO("Timer Exiting ...");
+            pushCastOutput(generation);
         }
 
-        uint32_t XCastImplementation::enableCastService(string friendlyname,bool enableService)
+        void XCastImplementation::pushCastOutput(uint64_t generation)
         {
-            LOGINFO("friendlyname[%s] status[%d]", friendlyname.c_str(), enableService);
+            //Pushes run one at a time; one that a newer output overtook is dropped, so gdial ends on the latest
+            lock_guard<mutex> pushLock(m_castOutputPushMutex);
+            string friendlyName;
+            bool enableService = false;
+            {
+                lock_guard<mutex> lck(m_castOutputMutex);
+                if (generation != m_castOutputGeneration)
+                {
+                    LOGINFO("Cast output [%llu] superseded by [%llu]", (unsigned long long)generation, (unsigned long long)m_castOutputGeneration);
+                    return;
+                }
+                friendlyName = friendlyNameCache;
+                enableService = xcastEnableCache;
+            }
+            LOGINFO("friendlyname[%s] status[%d]", friendlyName.c_str(), enableService);
             if (nullptr != m_xcast_manager)
             {
-                m_xcast_manager->enableCastService(friendlyname,enableService);
+                if (m_xcast_manager->isInitializePending())
+                {
+                    m_activationPending = true;
+                }
+                m_xcast_manager->enableCastService(friendlyName,enableService);
             }
-            xcastEnableCache = enableService;
-            friendlyNameCache = std::move(friendlyname);
-            return 0;
         }
 
         void XCastImplementation::startTimer(int interval)
@@ -813,19 +1095,23 @@ namespace WPEFramework
             _adminLock.Unlock();
         }
 
-        void XCastImplementation::dumpDynamicAppCacheList(string strListName, std::vector<DynamicAppConfig*>& appConfigList)
+        void XCastImplementation::dumpDynamicAppCacheList(string strListName, const DynamicAppConfigList& appConfigList)
         {
+            size_t memoryUsage = 0;
             LOGINFO ("=================Current Apps[%s] size[%d] ===========================", strListName.c_str(), (int)appConfigList.size());
-            for (DynamicAppConfig* pDynamicAppConfig : appConfigList)
+            for (const auto& pDynamicAppConfig : appConfigList)
             {
                 LOGINFO ("Apps: appName:%s, prefixes:%s, cors:%s, allowStop:%d, query:%s, payload:%s",
-                            pDynamicAppConfig->appName,
-                            pDynamicAppConfig->prefixes,
-                            pDynamicAppConfig->cors,
-                            pDynamicAppConfig->allowStop,
-                            pDynamicAppConfig->query,
-                            pDynamicAppConfig->payload);
-            }
+                            pDynamicAppConfig->appName(),
+                            pDynamicAppConfig->prefixes(),
+                            pDynamicAppConfig->cors(),
+                            pDynamicAppConfig->allowStop(),
+                            pDynamicAppConfig->query(),
+                            pDynamicAppConfig->payload());
+                memoryUsage += pDynamicAppConfig->memoryUsage();
+            }
+            LOGINFO ("Memory[%zu] bytes, fixed layout would use [%zu] bytes",
+                        memoryUsage, appConfigList.size() * DynamicAppConfig::fixedLayoutMemoryUsage());
             LOGINFO ("=================================================================");
         }
 
@@ -985,7 +1271,7 @@ namespace WPEFramework
                 checkPowerAndNetworkStandbyStates();
             }
 
-            if (m_xcastEnable && ( (m_standbyBehavior == true) || ((m_standbyBehavior == false)&&(m_powerState == WPEFramework::Exchange::IPowerManager::POWER_STATE_ON))))
+            if (isCastServiceActive())
             {
                 isEnabled = true;
                 registerPowerEventHandlers();
@@ -995,7 +1281,7 @@ namespace WPEFramework
                 unregisterPowerEventHandlers();
             }
             LOGINFO("m_xcastEnable[%d], isEnabled[%d]" , m_xcastEnable, isEnabled);
-            enableCastService(m_friendlyName,isEnabled);
+            updateCastAvailability();
             if (currentNetworkStandbyMode != m_networkStandbyMode) {
                 SetNetworkStandbyMode(m_networkStandbyMode);
             }
@@ -1029,9 +1315,15 @@ namespace WPEFramework
                 LOGERR("Invalid standby behavior [%d]", standbybehavior);
                 return Core::ERROR_GENERAL;
             }
+            bool changed = (m_standbyBehavior != enabled);
             m_standbyBehavior = enabled;
             success.success = true;
             LOGINFO("m_standbyBehavior[%d]", m_standbyBehavior);
+            if (changed)
+            {
+                //Only re-evaluates an output the client already established through enable or name
+                updateCastAvailability(true);
+            }
             return Core::ERROR_NONE;
         }
 
@@ -1052,15 +1344,10 @@ namespace WPEFramework
             uint32_t result = Core::ERROR_GENERAL;
 
             success.success = false;
-            bool enabledStatus = false;
             if (!friendlyname.empty())
             {
                 m_friendlyName = friendlyname;
-                if (m_xcastEnable && ( (m_standbyBehavior == true) || ((m_standbyBehavior == false)&&(m_powerState == WPEFramework::Exchange::IPowerManager::POWER_STATE_ON))))
-                {
-                    enabledStatus = true;
-                }
-                enableCastService(m_friendlyName,enabledStatus);
+                updateCastAvailability();
                 success.success = true;
                 result = Core::ERROR_NONE;
             }
@@ -1080,142 +1367,182 @@ namespace WPEFramework
             LOGINFO("Entering ...");
             bool ret = true;
             {lock_guard<mutex> lck(m_appConfigMutex);
-                /*Check if existing cache need to be updated*/
-                std::vector<int> entriesTodelete;
-                for (string appNameToDelete : appsToDelete) {
-                    bool found = false;
-                    int index = 0;
-                    for (DynamicAppConfig* pDynamicAppConfigOld : m_appConfigCache) {
-                        if (0 == strcmp(pDynamicAppConfigOld->appName, appNameToDelete.c_str())){
-                            entriesTodelete.push_back(index);
-                            found = true;
-                            break;
-                        }
-                        index ++;
+                DynamicAppRegistryPtr current = std::atomic_load(&m_appConfigCache);
+                std::shared_ptr<DynamicAppRegistry> updated = std::make_shared<DynamicAppRegistry>();
+                updated->apps.reserve(current->apps.size());
+                for (const auto& pDynamicAppConfig : current->apps) {
+                    if (std::find(appsToDelete.begin(), appsToDelete.end(), pDynamicAppConfig->appName()) == appsToDelete.end()) {
+                        updated->apps.push_back(pDynamicAppConfig);
                     }
-                    if (!found) {
-                        LOGINFO("[%s] not existing in the dynamic cache", appNameToDelete.c_str());
+                    else {
+                        LOGINFO("Going to delete the entry: [%s] from m_appConfigCache  size: [%d]", pDynamicAppConfig->appName(), (int)current->apps.size());
                     }
                 }
-                std::sort(entriesTodelete.begin(), entriesTodelete.end(), std::greater<int>());
-                for (int indexToDelete : entriesTodelete) {
-                    LOGINFO("Going to delete the entry: [%d] from m_appConfigCache  size: [%d]", indexToDelete, (int)m_appConfigCache.size());
-                    //Delete the old unwanted item here.
-                    DynamicAppConfig* pDynamicAppConfigOld = m_appConfigCache[indexToDelete];
-                    m_appConfigCache.erase (m_appConfigCache.begin()+indexToDelete);
-                    free (pDynamicAppConfigOld); pDynamicAppConfigOld = NULL;
+                if (appsToDelete.size() != (current->apps.size() - updated->apps.size())) {
+                    LOGINFO("Some of the [%d] requested apps are not existing in the dynamic cache", (int)appsToDelete.size());
+                }
+                if (updated->apps.size() != current->apps.size()) {
+                    publishDynamicAppCache(std::move(updated), *current);
                 }
-                entriesTodelete.clear();
             }
             LOGINFO("Exiting ...");
             //Even if requested app names not there return true.
             return ret;
         }
 
-        void XCastImplementation::updateDynamicAppCache(Exchange::IXCast::IApplicationInfoIterator* const appInfoList)
+        bool XCastImplementation::addDynamicAppConfig(const Exchange::IXCast::ApplicationInfo& appInfo, DynamicAppConfigList& appConfigList)
+        {
+            LOGINFO("Application: [%s]", appInfo.appName.c_str());
+            std::shared_ptr<const DynamicAppConfig> pDynamicAppConfig(new (std::nothrow) DynamicAppConfig(appInfo.appName,
+                                                                                                          appInfo.prefixes,
+                                                                                                          appInfo.cors,
+                                                                                                          appInfo.allowStop ? true : false,
+                                                                                                          appInfo.query,
+                                                                                                          appInfo.payload));
+            if(pDynamicAppConfig)
+            {
+                LOGINFO("appName[%s], prefixes[%s], cors[%s], allowStop[%d], query[%s], payload[%s]",
+                        pDynamicAppConfig->appName(),
+                        pDynamicAppConfig->prefixes(),
+                        pDynamicAppConfig->cors(),
+                        pDynamicAppConfig->allowStop(),
+                        pDynamicAppConfig->query(),
+                        pDynamicAppConfig->payload());
+                appConfigList.push_back (std::move(pDynamicAppConfig));
+                return true;
+            }
+            LOGERR("Memory allocation failed for DynamicAppConfig");
+            return false;
+        }
+
+        bool XCastImplementation::readDynamicAppConfigList(Exchange::IXCast::IApplicationInfoIterator* const appInfoList, DynamicAppConfigList& appConfigList)
         {
-            std::vector <DynamicAppConfig*> appConfigList;
             if (appInfoList != nullptr)
             {
                 LOGINFO("Applications:");
                 Exchange::IXCast::ApplicationInfo appInfo;
                 while (appInfoList->Next(appInfo))
                 {
-                    LOGINFO("Application: [%s]", appInfo.appName.c_str());
-                    DynamicAppConfig* pDynamicAppConfig = (DynamicAppConfig*) malloc (sizeof(DynamicAppConfig));
-                    if(pDynamicAppConfig)
+                    if (!addDynamicAppConfig(appInfo, appConfigList))
                     {
-                        memset ((void*)pDynamicAppConfig, '\0', sizeof(DynamicAppConfig));
-
-                        memset (pDynamicAppConfig->appName, '\0', sizeof(pDynamicAppConfig->appName));
-                        strncpy (pDynamicAppConfig->appName, appInfo.appName.c_str(), sizeof(pDynamicAppConfig->appName) - 1);
-                        pDynamicAppConfig->appName[sizeof(pDynamicAppConfig->appName) - 1] = '\0';
-
-                        memset (pDynamicAppConfig->prefixes, '\0', sizeof(pDynamicAppConfig->prefixes));
-                        strncpy (pDynamicAppConfig->prefixes, appInfo.prefixes.c_str(), sizeof(pDynamicAppConfig->prefixes) - 1);
-                        pDynamicAppConfig->prefixes[sizeof(pDynamicAppConfig->prefixes) - 1] = '\0';
-
-                        memset (pDynamicAppConfig->cors, '\0', sizeof(pDynamicAppConfig->cors));
-                        strncpy (pDynamicAppConfig->cors, appInfo.cors.c_str(), sizeof(pDynamicAppConfig->cors) - 1);
-                        pDynamicAppConfig->cors[sizeof(pDynamicAppConfig->cors) - 1] = '\0';
-
-                        memset (pDynamicAppConfig->query, '\0', sizeof(pDynamicAppConfig->query));
-                        strncpy (pDynamicAppConfig->query, appInfo.query.c_str(), sizeof(pDynamicAppConfig->query) - 1);
-                        pDynamicAppConfig->query[sizeof(pDynamicAppConfig->query) - 1] = '\0';
-
-                        memset (pDynamicAppConfig->payload, '\0', sizeof(pDynamicAppConfig->payload));
-                        strncpy (pDynamicAppConfig->payload, appInfo.payload.c_str(), sizeof(pDynamicAppConfig->payload) - 1);
-                        pDynamicAppConfig->payload[sizeof(pDynamicAppConfig->payload) - 1] = '\0';
-
-                        pDynamicAppConfig->allowStop = appInfo.allowStop ? true : false;
-
-                        LOGINFO("appName[%s], prefixes[%s], cors[%s], allowStop[%d], query[%s], payload[%s]",
-                                pDynamicAppConfig->appName,
-                                pDynamicAppConfig->prefixes,
-                                pDynamicAppConfig->cors,
-                                pDynamicAppConfig->allowStop,
-                                pDynamicAppConfig->query,
-                                pDynamicAppConfig->payload);
-                        appConfigList.push_back (pDynamicAppConfig);
-                    }
-                    else
-                    {
-                        LOGERR("Memory allocation failed for DynamicAppConfig");
-                        return;
+                        return false;
                     }
                 }
             }
+            return true;
+        }
 
-            dumpDynamicAppCacheList(string("appConfigList"), appConfigList);
-            vector<string> appsToDelete;
-            for (DynamicAppConfig* pDynamicAppConfig : appConfigList) {
-                    appsToDelete.push_back(string(pDynamicAppConfig->appName));
+        bool XCastImplementation::readDynamicAppConfigList(const string& applications, DynamicAppConfigList& appConfigList)
+        {
+            JsonArray applicationArray;
+            if (!applications.empty() && !applicationArray.FromString(applications))
+            {
+                LOGERR("Malformed applications array");
+                return false;
+            }
+            LOGINFO("Applications:");
+            // Same application fields as registerApplications
+            for (uint16_t index = 0; index < applicationArray.Length(); ++index)
+            {
+                JsonObject application = applicationArray[index].Object();
+                const JsonValue& allowStop = application["allowStop"];
+                Exchange::IXCast::ApplicationInfo appInfo;
+                appInfo.appName = application["name"].String();
+                appInfo.prefixes = application["prefix"].String();
+                appInfo.cors = application["cors"].String();
+                appInfo.query = application["query"].String();
+                appInfo.payload = application["payload"].String();
+                appInfo.allowStop = (Core::JSON::Variant::type::BOOLEAN == allowStop.Content()) ? allowStop.Boolean() : (0 != allowStop.Number());
+                if (!addDynamicAppConfig(appInfo, appConfigList))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void XCastImplementation::mergeIntoDynamicAppCache(DynamicAppConfigList& apps, DynamicAppConfigList& appConfigList)
+        {
+            for (auto& pDynamicAppConfig : appConfigList) {
+                auto itr = std::find_if(apps.begin(), apps.end(),
+                                        [&pDynamicAppConfig](const std::shared_ptr<const DynamicAppConfig>& pDynamicAppConfigOld) {
+                                            return (0 == strcmp(pDynamicAppConfigOld->appName(), pDynamicAppConfig->appName()));
+                                        });
+                if (itr != apps.end()) {
+                    LOGINFO("Replacing [%s] in m_appConfigCache", pDynamicAppConfig->appName());
+                    *itr = std::move(pDynamicAppConfig);
+                }
+                else {
+                    apps.push_back(std::move(pDynamicAppConfig));
+                }
             }
-            deleteFromDynamicAppCache (appsToDelete);
+        }
 
+        void XCastImplementation::updateDynamicAppCache(Exchange::IXCast::IApplicationInfoIterator* const appInfoList)
+        {
+            DynamicAppConfigList appConfigList;
+            if (!readDynamicAppConfigList(appInfoList, appConfigList))
+            {
+                return;
+            }
+
+            dumpDynamicAppCacheList(string("appConfigList"), appConfigList);
             LOGINFO("appConfigList count[%d]", (int)appConfigList.size());
-            //Update the new entries here.
+            //Build the new table off to the side and publish it in one step.
+            DynamicAppRegistryPtr published;
             {
                 lock_guard<mutex> lck(m_appConfigMutex);
-                for (DynamicAppConfig* pDynamicAppConfig : appConfigList) {
-                    m_appConfigCache.push_back(pDynamicAppConfig);
-                }
-                LOGINFO("m_appConfigCache count[%d]", (int)m_appConfigCache.size());
-            }
-            //Clear the tempopary list here
-            appsToDelete.clear();
-            appConfigList.clear();
-            lock_guard<mutex> lck(m_appConfigMutex);
-            dumpDynamicAppCacheList(string("m_appConfigCache"), m_appConfigCache);
+                DynamicAppRegistryPtr current = std::atomic_load(&m_appConfigCache);
+                std::shared_ptr<DynamicAppRegistry> updated = std::make_shared<DynamicAppRegistry>();
+                updated->apps = current->apps;
+                mergeIntoDynamicAppCache(updated->apps, appConfigList);
+                published = publishDynamicAppCache(std::move(updated), *current);
+            }
+            LOGINFO("m_appConfigCache count[%d] generation[%llu]", (int)published->apps.size(), (unsigned long long)published->generation);
+            dumpDynamicAppCacheList(string("m_appConfigCache"), published->apps);
             return;
         }
 
+        DynamicAppRegistryPtr XCastImplementation::publishDynamicAppCache(std::shared_ptr<DynamicAppRegistry> updated, const DynamicAppRegistry& current)
+        {
+            updated->generation = current.generation + 1;
+            size_t conflicts = updated->index.build(updated->apps);
+            if (0 != conflicts) {
+                LOGWARN("[%zu] app names or prefixes are claimed by more than one registration, first one wins", conflicts);
+            }
+            DynamicAppRegistryPtr published(std::move(updated));
+            std::atomic_store(&m_appConfigCache, published);
+            return published;
+        }
+
+        bool XCastImplementation::isKnownApplication(const string& appName)
+        {
+            DynamicAppRegistryPtr appRegistry = std::atomic_load(&m_appConfigCache);
+            if (appRegistry->apps.empty()) {
+                return true;
+            }
+            const DynamicAppConfig* pDynamicAppConfig = appRegistry->resolve(appName);
+            if (nullptr != pDynamicAppConfig) {
+                LOGINFO("[%s] resolved to registration [%s]", appName.c_str(), pDynamicAppConfig->appName());
+                return true;
+            }
+            //Without gdial's default app list the request cannot be judged, let it through
+            if ((nullptr == m_xcast_manager) || m_xcast_manager->isDefaultApplication(appName)) {
+                return true;
+            }
+            LOGWARN("[%s] is neither registered nor a default app, dropping the request", appName.c_str());
+            return false;
+        }
+
         Core::hresult XCastImplementation::RegisterApplications(Exchange::IXCast::IApplicationInfoIterator* const appInfoList, Exchange::IXCast::XCastSuccess &success)
         {
             LOGINFO("Entering ...");
-            enableCastService(m_friendlyName,false);
-            m_isDynamicRegistrationsRequired = true;
+            // Entries have no owner: neither the generated JSON-RPC glue nor COM-RPC tells us the caller,
+            // so a restarting client must unregister its apps or replace the set with updateApplications
             updateDynamicAppCache(appInfoList);
-            std::vector<DynamicAppConfig*> appConfigList;
-            {
-                lock_guard<mutex> lck(m_appConfigMutex);
-                appConfigList = m_appConfigCache;
-            }
-            dumpDynamicAppCacheList(string("m_appConfigCache"), appConfigList);
-            lock_guard<mutex> lck(m_appConfigMutex);
-            //Pass the dynamic cache to xdial process
+            //Pass the dynamic cache to xdial process, cast service stays advertised while gdial swaps its table
             if (nullptr != m_xcast_manager) {
-                m_xcast_manager->registerApplications(m_appConfigCache);
-            }
-
-            LOGINFO("m_xcastEnable[%d] m_standbyBehavior[%d] m_powerState[%d]", m_xcastEnable, m_standbyBehavior, m_powerState);
-            /*Reenabling cast service after registering Applications*/
-            if (m_xcastEnable && ( (m_standbyBehavior == true) || ((m_standbyBehavior == false)&&(m_powerState == WPEFramework::Exchange::IPowerManager::POWER_STATE_ON))))
-            {
-                enableCastService(m_friendlyName,true);
-            }
-            else {
-                LOGINFO("CastService not enabled");
+                m_xcast_manager->registerApplications(std::atomic_load(&m_appConfigCache));
             }
             success.success = true;
             LOGINFO("Exiting ...");
@@ -1226,9 +1553,6 @@ namespace WPEFramework
         {
             LOGINFO("Entering ...");
             auto returnStatus = false;
-            /*Disable cast service before registering Applications*/
-            enableCastService(m_friendlyName,false);
-            m_isDynamicRegistrationsRequired = true;
 
             std::vector<string> appsToDelete;
             string appName;
@@ -1240,28 +1564,116 @@ namespace WPEFramework
 
             returnStatus = deleteFromDynamicAppCache(appsToDelete);
 
-            std::vector<DynamicAppConfig*> appConfigList;
+            DynamicAppRegistryPtr appRegistry = std::atomic_load(&m_appConfigCache);
+            dumpDynamicAppCacheList(string("m_appConfigCache"), appRegistry->apps);
+            if (nullptr != m_xcast_manager) {
+                m_xcast_manager->registerApplications(appRegistry);
+            }
+            success.success = (returnStatus)? true : false;
+            LOGINFO("Exiting ...");
+            return (returnStatus)? Core::ERROR_NONE : Core::ERROR_GENERAL;
+        }
+
+        Core::hresult XCastImplementation::UpdateApplications(const bool replaceAll, const string& appsToAdd, const string& appsToRemove, Exchange::IXCast::XCastSuccess &success)
+        {
+            LOGINFO("Entering ... replaceAll[%d]", replaceAll);
+            success.success = false;
+
+            //Parse both sets before touching the registry so nothing partial is ever published
+            DynamicAppConfigList appConfigList;
+            if (!readDynamicAppConfigList(appsToAdd, appConfigList))
+            {
+                return Core::ERROR_GENERAL;
+            }
+            JsonArray names;
+            if (!appsToRemove.empty() && !names.FromString(appsToRemove))
+            {
+                LOGERR("Malformed remove array");
+                return Core::ERROR_GENERAL;
+            }
+            std::vector<string> appsToDelete;
+            for (uint16_t index = 0; index < names.Length(); ++index)
+            {
+                appsToDelete.push_back(names[index].String());
+            }
+
+            DynamicAppRegistryPtr published;
             {
                 lock_guard<mutex> lck(m_appConfigMutex);
-                appConfigList = m_appConfigCache;
+                DynamicAppRegistryPtr current = std::atomic_load(&m_appConfigCache);
+                std::shared_ptr<DynamicAppRegistry> updated = std::make_shared<DynamicAppRegistry>();
+                if (!replaceAll) {
+                    updated->apps.reserve(current->apps.size() + appConfigList.size());
+                    for (const auto& pDynamicAppConfig : current->apps) {
+                        if (std::find(appsToDelete.begin(), appsToDelete.end(), pDynamicAppConfig->appName()) == appsToDelete.end()) {
+                            updated->apps.push_back(pDynamicAppConfig);
+                        }
+                    }
+                }
+                mergeIntoDynamicAppCache(updated->apps, appConfigList);
+                published = publishDynamicAppCache(std::move(updated), *current);
             }
-            dumpDynamicAppCacheList(string("m_appConfigCache"), appConfigList);
+            LOGINFO("added[%d] removed[%d] m_appConfigCache count[%d] generation[%llu]",
+                    (int)appConfigList.size(), (int)appsToDelete.size(), (int)published->apps.size(), (unsigned long long)published->generation);
+
             if (nullptr != m_xcast_manager) {
-                m_xcast_manager->registerApplications(appConfigList);
+                m_xcast_manager->registerApplications(published);
             }
+            success.success = true;
+            LOGINFO("Exiting ...");
+            return Core::ERROR_NONE;
+        }
+
+        Core::hresult XCastImplementation::GetRegisteredApplications(const uint32_t offset, const uint32_t limit, const uint32_t fields, Exchange::IXCast::IApplicationInfoIterator*& appInfoList, uint32_t& total)
+        {
+            DynamicAppRegistryPtr appRegistry = std::atomic_load(&m_appConfigCache);
+            const uint32_t mask = (0 == fields) ? DYNAMIC_APP_FIELD_ALL : fields;
+            std::list<Exchange::IXCast::ApplicationInfo> appInfos;
 
-            LOGINFO("m_xcastEnable[%d] m_standbyBehavior[%d] m_powerState[%d]", m_xcastEnable, m_standbyBehavior, m_powerState);
-            /*Reenabling cast service after registering Applications*/
-            if (m_xcastEnable && ( (m_standbyBehavior == true) || ((m_standbyBehavior == false)&&(m_powerState == WPEFramework::Exchange::IPowerManager::POWER_STATE_ON))))
+            total = (uint32_t)appRegistry->apps.size();
+            for (uint32_t index = offset; (index < total) && ((0 == limit) || (appInfos.size() < limit)); ++index)
             {
-                enableCastService(m_friendlyName,true);
+                const DynamicAppConfig& appConfig = *appRegistry->apps[index];
+                Exchange::IXCast::ApplicationInfo appInfo;
+                appInfo.appName = appConfig.appName();
+                appInfo.prefixes = (mask & DYNAMIC_APP_FIELD_PREFIXES) ? appConfig.prefixes() : "";
+                appInfo.cors = (mask & DYNAMIC_APP_FIELD_CORS) ? appConfig.cors() : "";
+                appInfo.allowStop = ((mask & DYNAMIC_APP_FIELD_ALLOW_STOP) && appConfig.allowStop()) ? true : false;
+                appInfo.query = (mask & DYNAMIC_APP_FIELD_QUERY) ? appConfig.query() : "";
+                appInfo.payload = (mask & DYNAMIC_APP_FIELD_PAYLOAD) ? appConfig.payload() : "";
+                appInfos.push_back(std::move(appInfo));
+            }
+            LOGINFO("offset[%u] limit[%u] fields[0x%x] returning [%u] of [%u] generation[%llu]",
+                    offset, limit, mask, (uint32_t)appInfos.size(), total, (unsigned long long)appRegistry->generation);
+
+            appInfoList = Core::Service<RPC::IteratorType<Exchange::IXCast::IApplicationInfoIterator>>::Create<Exchange::IXCast::IApplicationInfoIterator>(appInfos);
+            return Core::ERROR_NONE;
+        }
+
+        Core::hresult XCastImplementation::GetGDialCallStats(std::list<IXCastRegistry::GDialCallStats>& stats)
+        {
+            stats.clear();
+            if (nullptr == m_xcast_manager)
+            {
+                return Core::ERROR_UNAVAILABLE;
             }
-            else {
-                LOGINFO("CastService not enabled");
+            for (int operation = 0; operation < XCastManager::GDIAL_OP_COUNT; ++operation)
+            {
+                XCastManager::GDialCallStats counters;
+                if (m_xcast_manager->getGDialCallStats((XCastManager::GDialOperation)operation, counters) && (0 != counters.calls))
+                {
+                    IXCastRegistry::GDialCallStats entry;
+                    entry.operation = XCastManager::getGDialOperationName((XCastManager::GDialOperation)operation);
+                    entry.calls = counters.calls;
+                    entry.errors = counters.errors;
+                    entry.totalMicros = counters.totalMicros;
+                    entry.maxMicros = counters.maxMicros;
+                    entry.histogram.assign(counters.histogram, counters.histogram + XCastManager::GDIAL_LATENCY_BUCKETS);
+                    entry.bucketBoundsMicros.assign(XCastManager::GDIAL_LATENCY_BUCKET_LIMITS, XCastManager::GDIAL_LATENCY_BUCKET_LIMITS + XCastManager::GDIAL_LATENCY_BUCKETS - 1);
+                    stats.push_back(std::move(entry));
+                }
             }
-            success.success = (returnStatus)? true : false;
-            LOGINFO("Exiting ...");
-            return (returnStatus)? Core::ERROR_NONE : Core::ERROR_GENERAL;
+            return Core::ERROR_NONE;
         }
 
         bool XCastImplementation::setPowerState(const string &powerState)
@@ -30,8 +30,10 @@
 #include <core/core.h>
 #include <mutex>
 #include <vector>
+#include <chrono>
 #include <glib.h> 
 
+#include "IXCastRegistry.h"
 #include "XCastManager.h"
 #include "XCastNotifier.h"
 
@@ -50,7 +52,7 @@ namespace WPEFramework
     namespace Plugin
     {
         WPEFramework::Exchange::IPowerManager::PowerState m_powerState = WPEFramework::Exchange::IPowerManager::POWER_STATE_STANDBY;
-        class XCastImplementation : public Exchange::IXCast,public Exchange::IConfiguration, public XCastNotifier 
+        class XCastImplementation : public Exchange::IXCast, public IXCastRegistry, public Exchange::IConfiguration, public XCastNotifier 
         {
          public:
             enum PluginState
@@ -223,6 +225,11 @@ namespace WPEFramework
             Core::hresult RegisterApplications(Exchange::IXCast::IApplicationInfoIterator* const appInfoList,  Exchange::IXCast::XCastSuccess &success) override;
             Core::hresult UnregisterApplications(Exchange::IXCast::IStringIterator* const apps,  Exchange::IXCast::XCastSuccess &success) override;
 
+            // IXCastRegistry; GetRegisteredApplications pages through the registry snapshot without taking any lock.
+            Core::hresult GetRegisteredApplications(const uint32_t offset, const uint32_t limit, const uint32_t fields, Exchange::IXCast::IApplicationInfoIterator*& appInfoList, uint32_t& total) override;
+            Core::hresult UpdateApplications(const bool replaceAll, const string& appsToAdd, const string& appsToRemove, Exchange::IXCast::XCastSuccess& success) override;
+            Core::hresult GetGDialCallStats(std::list<IXCastRegistry::GDialCallStats>& stats) override;
+
             virtual void onXcastApplicationLaunchRequestWithParam (string appName, string strPayLoad, string strQuery, string strAddDataUrl) override ;
             virtual void onXcastApplicationLaunchRequest(string appName, string parameter) override ;
             virtual void onXcastApplicationStopRequest(string appName, string appId) override ;
@@ -253,14 +260,24 @@ namespace WPEFramework
             bool _registeredNMEventHandlers;
 
         private:
+            // Whether the current gdial instance was given the cached cast output, guarded by m_castOutputMutex
+            bool m_castOutputApplied = false;
+            uint64_t m_castOutputSkipped = 0;
+            // Bumped for every output decided under m_castOutputMutex, a push only goes out while it is still the latest
+            uint64_t m_castOutputGeneration = 0;
+            std::mutex m_castOutputMutex;
+            // Held across the gdial call instead of m_castOutputMutex
+            std::mutex m_castOutputPushMutex;
             Exchange::INetworkManager* _networkManagerPlugin;
             mutable Core::CriticalSection _adminLock;
              
             std::list<Exchange::IXCast::INotification *> _xcastNotification; // List of registered notifications
             Core::Sink<NetworkManagerNotification> _networkManagerNotification;
 
-            void dumpDynamicAppCacheList(string strListName, std::vector<DynamicAppConfig*>& appConfigList);
+            void dumpDynamicAppCacheList(string strListName, const DynamicAppConfigList& appConfigList);
             bool deleteFromDynamicAppCache(vector<string>& appsToDelete);
+            DynamicAppRegistryPtr publishDynamicAppCache(std::shared_ptr<DynamicAppRegistry> updated, const DynamicAppRegistry& current);
+            bool isKnownApplication(const string& appName);
 
             void dispatchEvent(Event,string callsign, const JsonObject &params);
             void Dispatch(Event event,string callsign, const JsonObject params);
@@ -285,11 +302,27 @@ namespace WPEFramework
             void unregisterNetworkEventHandlers();
             void InitializeNetworkManager(PluginHost::IShell *service);
             string getInterfaceNameToType(const string & interface);
+            void loadInterfaceTypeRules(PluginHost::IShell* service);
+            void parseInterfaceTypeRules(const string& rules);
 
-            bool connectToGDialService(void);
+            enum GDialConnectReason
+            {
+                GDIAL_CONNECT_ACTIVATION,
+                GDIAL_CONNECT_TIMER,
+                GDIAL_CONNECT_WARM_RESTART
+            };
+            bool connectToGDialService(GDialConnectReason reason);
+            void onGDialServiceConnected(bool status, const string& interfaceType, GDialConnectReason reason, std::chrono::steady_clock::time_point requested);
+            void warmRestartGDialService(void);
             bool getDefaultNameAndIPAddress(std::string& interface, std::string& ipaddress);
+            bool isBoundInterfaceServing(const std::string& nwInterface, const std::string& ipaddress);
+            bool getInterfaceIPAddress(const std::string& nwInterface, std::string& ipaddress);
             void updateNWConnectivityStatus(std::string nwInterface, bool nwConnected, std::string ipaddress = "");
-            uint32_t enableCastService(string friendlyname,bool enableService);
+            void pushCastOutput(uint64_t generation);
+            // Cast availability: enable, standby behavior and power decide active, the friendly
+            // name goes along. gdial is only told when (active, friendly name) changes.
+            bool isCastServiceActive(void);
+            void updateCastAvailability(bool onlyIfApplied = false);
             uint32_t Configure(PluginHost::IShell* shell);
             
             void getSystemPlugin();
@@ -301,6 +334,10 @@ namespace WPEFramework
             uint32_t SetNetworkStandbyMode(bool networkStandbyMode);
             bool setPowerState(const std::string& powerState);
             void updateDynamicAppCache(Exchange::IXCast::IApplicationInfoIterator* const appInfoList);
+            bool readDynamicAppConfigList(Exchange::IXCast::IApplicationInfoIterator* const appInfoList, DynamicAppConfigList& appConfigList);
+            bool readDynamicAppConfigList(const string& applications, DynamicAppConfigList& appConfigList);
+            bool addDynamicAppConfig(const Exchange::IXCast::ApplicationInfo& appInfo, DynamicAppConfigList& appConfigList);
+            void mergeIntoDynamicAppCache(DynamicAppConfigList& apps, DynamicAppConfigList& appConfigList);
             
         public:
             static XCastImplementation* _instance;
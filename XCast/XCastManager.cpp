@@ -23,13 +23,26 @@
 #include <interfaces/IConfiguration.h>
 #include <interfaces/IDeviceInfo.h>
 #include <cryptalgo/Hash.h>
+#include <cstring>
 #include <sstream>
 #include <iomanip>
+#include <sys/stat.h>
+#include <chrono>
+#include <future>
+#include <iterator>
 
 using namespace std;
 using namespace WPEFramework;
 
 #define COMMON_DEVICE_PROPERTIES_FILE   "/etc/device.properties"
+#define RECEIVER_ID_GPID_FILE           "/tmp/gpid.txt"
+#define RECEIVER_ID_AUTHSERVICE_FILE    "/opt/www/authService/deviceid.dat"
+#define RECEIVER_ID_WHITEBOX_FILE       "/opt/www/whitebox/wbdevice.dat"
+#define XCAST_IDENTITY_CACHE_FILE       "xcast_identity.cache"
+#define XCAST_RFC_REFRESH_INTERVAL_SECONDS  600  //10 minutes
+#define XCAST_LIVENESS_PROBE_INTERVAL_SECONDS  30
+#define XCAST_LIVENESS_CONFIRM_INTERVAL_SECONDS  1
+#define XCAST_LIVENESS_PROBE_TIMEOUT_MS  2000
 
 #define LOCATE_CAST_FIRST_TIMEOUT_IN_MILLIS  5000  //5 seconds
 #define LOCATE_CAST_SECOND_TIMEOUT_IN_MILLIS 15000  //15 seconds
@@ -39,12 +52,39 @@ using namespace WPEFramework;
 
 
 static gdialService* gdialCastObj = NULL;
+//-I of the running gdial instance, guarded by m_gdialMutex like gdialCastObj
+static std::string gdialInterfaceName;
 XCastManager * XCastManager::_instance = nullptr;
-std::string m_modelName = "";
-std::string m_manufacturerName = "";
-std::string m_defaultfriendlyName = "";
-std::string m_uuid = "";
-std::string m_defaultAppList = "";
+
+//Device metadata handed to gdial. Replaced as a whole so the getters read it without a lock.
+struct DeviceMetadata
+{
+    std::string modelName;
+    std::string manufacturerName;
+    std::string defaultfriendlyName;
+    std::string uuid;
+    std::string defaultAppList;
+    std::string protocolVersion; //of the current gdial instance, empty until queried
+};
+typedef std::shared_ptr<const DeviceMetadata> DeviceMetadataPtr;
+static DeviceMetadataPtr m_deviceMetadata = std::make_shared<const DeviceMetadata>();
+static std::mutex m_deviceMetadataMutex;
+
+static DeviceMetadataPtr getDeviceMetadata(void)
+{
+    return std::atomic_load(&m_deviceMetadata);
+}
+
+template <typename UPDATE>
+static DeviceMetadataPtr updateDeviceMetadata(UPDATE update)
+{
+    lock_guard<mutex> lock(m_deviceMetadataMutex);
+    std::shared_ptr<DeviceMetadata> updated = std::make_shared<DeviceMetadata>(*getDeviceMetadata());
+    update(*updated);
+    DeviceMetadataPtr published(std::move(updated));
+    std::atomic_store(&m_deviceMetadata, published);
+    return published;
+}
 
 //XDIALCAST EVENT CALLBACK
 /**
@@ -108,24 +148,15 @@ void XCastManager::updatePowerState(string powerState)
 
 XCastManager::~XCastManager()
 {
+    stopRFCRefresh();
+    stopLivenessProbe();
     _instance = nullptr;
     m_observer = nullptr;
 }
 
-bool XCastManager::initialize(WPEFramework::PluginHost::IShell* pluginService, const std::string& gdial_interface_name, bool networkStandbyMode )
+XCastManager::RFCInputs XCastManager::getRFCInputs(void)
 {
-    std::vector<std::string> gdial_args;
-    bool returnValue = false,
-         isFriendlyNameEnabled = true,
-         isWolWakeEnableEnabled = true;
-
-    if (gdial_interface_name.empty())
-    {
-        LOGERR("Interface Name should not be empty");
-        return false;
-    }
-
-    lock_guard<recursive_mutex> lock(m_mutexSync);
+    RFCInputs inputs;
 #ifdef RFC_ENABLED
     RFC_ParamData_t param = {0};
     WDMP_STATUS wdmpStatus = WDMP_SUCCESS;
@@ -135,8 +166,8 @@ bool XCastManager::initialize(WPEFramework::PluginHost::IShell* pluginService, c
         if( param.type == WDMP_BOOLEAN )
         {
             if(strncasecmp(param.value,"true",4) != 0 ) {
-                LOGINFO("----------XCAST RFC Disabled---------- ");
-                return true;
+                inputs.isXDialEnabled = false;
+                return inputs;
             }
         }
     }
@@ -146,10 +177,10 @@ bool XCastManager::initialize(WPEFramework::PluginHost::IShell* pluginService, c
         if( param.type == WDMP_BOOLEAN )
         {
             if(strncasecmp(param.value,"true",4) == 0 ) {
-                isFriendlyNameEnabled = true;
+                inputs.isFriendlyNameEnabled = true;
             }
             else{
-                isFriendlyNameEnabled = false;
+                inputs.isFriendlyNameEnabled = false;
             }
         }
     }
@@ -159,10 +190,10 @@ bool XCastManager::initialize(WPEFramework::PluginHost::IShell* pluginService, c
         if( param.type == WDMP_BOOLEAN )
         {
             if(strncasecmp(param.value,"true",4) == 0 ) {
-                isWolWakeEnableEnabled = true;
+                inputs.isWolWakeEnableEnabled = true;
             }
             else {
-                isWolWakeEnableEnabled = false;
+                inputs.isWolWakeEnableEnabled = false;
             }
         }
     }
@@ -171,103 +202,359 @@ bool XCastManager::initialize(WPEFramework::PluginHost::IShell* pluginService, c
     {
         if( param.type == WDMP_STRING )
         {
-            m_defaultAppList = param.value;
+            inputs.hasAppList = true;
+            inputs.appList = param.value;
         }
     }
 #endif //RFC_ENABLED
-    std::string temp_interface = "";
-    getGDialInterfaceName(temp_interface);
+    return inputs;
+}
 
-    if (0 == gdial_interface_name.compare("ETHERNET"))
+bool XCastManager::getCachedRFCInputs(RFCInputs& inputs)
+{
+    lock_guard<mutex> lock(m_rfcMutex);
+    if (m_rfcInputsValid)
     {
-        LOGINFO("VIface[%s:%s] uses \"eth0\"",gdial_interface_name.c_str(),temp_interface.c_str());
-        temp_interface = "eth0";
+        inputs = m_rfcInputs;
     }
-    else if (0 == gdial_interface_name.compare("WIFI"))
+    return m_rfcInputsValid;
+}
+
+XCastManager::RFCInputs XCastManager::fetchRFCInputs(void)
+{
+    RFCInputs inputs = getRFCInputs();
+    lock_guard<mutex> lock(m_rfcMutex);
+    m_rfcInputs = inputs;
+    m_rfcInputsValid = true;
+    if (!m_rfcRefreshThread.joinable() && !m_rfcRefreshStop)
     {
-        LOGINFO("VIface[%s:%s] uses \"wlan0\"",gdial_interface_name.c_str(),temp_interface.c_str());
-        temp_interface = "wlan0";
+        m_rfcRefreshThread = std::thread(&XCastManager::runRFCRefresh, this);
     }
-    else
+    return inputs;
+}
+
+void XCastManager::setRFCChangeCallback(RFCChangeCallback callback)
+{
+    lock_guard<mutex> lock(m_rfcMutex);
+    m_rfcChangeCallback = std::move(callback);
+}
+
+bool XCastManager::refreshRFCInputs(void)
+{
+    RFCInputs current = getRFCInputs();
+    RFCInputs previous;
+    RFCChangeCallback callback;
+    bool wasValid = false;
     {
-        LOGINFO("Actual IFace[%s]",temp_interface.c_str());
+        lock_guard<mutex> lock(m_rfcMutex);
+        previous = m_rfcInputs;
+        wasValid = m_rfcInputsValid;
+        m_rfcInputs = current;
+        m_rfcInputsValid = true;
+        callback = m_rfcChangeCallback;
+    }
+    if (!wasValid || !applyRFCInputs(previous, current))
+    {
+        return false;
     }
+    if (callback)
+    {
+        callback();
+    }
+    return true;
+}
 
-    gdial_args.push_back("-I");
-    gdial_args.push_back(std::move(temp_interface));
+bool XCastManager::applyRFCInputs(const RFCInputs& previous, const RFCInputs& current)
+{
+    bool restartRequired = false;
+    if ((previous.hasAppList != current.hasAppList) ||
+        (current.hasAppList && (previous.appList != current.appList)))
+    {
+        //gdial was launched with the old list as -A
+        LOGINFO("XDial AppList changed to [%s]", current.appList.c_str());
+        if (current.hasAppList)
+        {
+            std::string appList = current.appList;
+            updateDeviceMetadata([&appList](DeviceMetadata& published) { published.defaultAppList = std::move(appList); });
+        }
+        restartRequired = true;
+    }
+    if ((previous.isXDialEnabled != current.isXDialEnabled) ||
+        (previous.isFriendlyNameEnabled != current.isFriendlyNameEnabled) ||
+        (previous.isWolWakeEnableEnabled != current.isWolWakeEnableEnabled))
+    {
+        LOGINFO("XDial RFC changed Enable[%d->%d] FriendlyNameEnable[%d->%d] WolWakeEnable[%d->%d]",
+                previous.isXDialEnabled, current.isXDialEnabled,
+                previous.isFriendlyNameEnabled, current.isFriendlyNameEnabled,
+                previous.isWolWakeEnableEnabled, current.isWolWakeEnableEnabled);
+        restartRequired = true;
+    }
+    return restartRequired;
+}
 
-    if (m_uuid.empty())
+void XCastManager::runRFCRefresh(void)
+{
+    unique_lock<mutex> lock(m_rfcMutex);
+    while (!m_rfcRefreshWake.wait_for(lock, std::chrono::seconds(XCAST_RFC_REFRESH_INTERVAL_SECONDS),
+                                      [this]() { return m_rfcRefreshStop; }))
     {
-        m_uuid = getReceiverID(pluginService);
+        lock.unlock();
+        refreshRFCInputs();
+        lock.lock();
     }
+}
 
-    if (!m_uuid.empty())
+void XCastManager::stopRFCRefresh(void)
+{
     {
-        gdial_args.push_back("-U");
-        gdial_args.push_back(m_uuid);
+        lock_guard<mutex> lock(m_rfcMutex);
+        m_rfcRefreshStop = true;
+        m_rfcChangeCallback = nullptr;
+    }
+    m_rfcRefreshWake.notify_all();
+    if (m_rfcRefreshThread.joinable() && (std::this_thread::get_id() != m_rfcRefreshThread.get_id()))
+    {
+        m_rfcRefreshThread.join();
+    }
+}
+
+bool XCastManager::initialize(WPEFramework::PluginHost::IShell* pluginService, const std::string& gdial_interface_name, const std::string& interfaceType, bool networkStandbyMode )
+{
+    return initialize(pluginService, gdial_interface_name, interfaceType, networkStandbyMode, m_initializeEpoch.load());
+}
+
+bool XCastManager::initializeAsync(WPEFramework::PluginHost::IShell* pluginService, const std::string& gdial_interface_name, const std::string& interfaceType, bool networkStandbyMode, InitializeCallback callback)
+{
+    lock_guard<mutex> stateLock(m_initializeStateMutex);
+    if (m_initializePending)
+    {
+        LOGINFO("gdial initialize already in progress");
+        return false;
+    }
+    //The previous worker cleared the pending flag on its way out, this join does not block on it
+    if (m_initializeThread.joinable())
+    {
+        m_initializeThread.join();
     }
+    m_initializePending = true;
+    const uint64_t epoch = m_initializeEpoch.load();
+    m_initializeThread = std::thread([this, pluginService, gdial_interface_name, interfaceType, networkStandbyMode, callback, epoch]()
+    {
+        auto start = std::chrono::steady_clock::now();
+        bool status = initialize(pluginService, gdial_interface_name, interfaceType, networkStandbyMode, epoch);
+        {
+            lock_guard<mutex> callbackLock(m_initializeCallbackMutex);
+            if (epoch == m_initializeEpoch.load())
+            {
+                LOGINFO("gdial initialize [%u] in [%lld] ms", status,
+                        (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+                if (callback)
+                {
+                    callback(status);
+                }
+            }
+            else
+            {
+                LOGINFO("gdial initialize cancelled");
+            }
+        }
+        {
+            lock_guard<mutex> stateLock(m_initializeStateMutex);
+            m_initializePending = false;
+        }
+        m_initializeDone.notify_all();
+    });
+    return true;
+}
+
+void XCastManager::cancelInitialize()
+{
+    lock_guard<mutex> callbackLock(m_initializeCallbackMutex);
+    ++m_initializeEpoch;
+}
+
+bool XCastManager::isInitializePending()
+{
+    lock_guard<mutex> stateLock(m_initializeStateMutex);
+    return m_initializePending;
+}
+
+bool XCastManager::waitForInitialize(uint32_t timeoutMs)
+{
+    unique_lock<mutex> stateLock(m_initializeStateMutex);
+    return m_initializeDone.wait_for(stateLock, std::chrono::milliseconds(timeoutMs), [this]() { return !m_initializePending; });
+}
 
-    if (m_modelName.empty())
+bool XCastManager::initialize(WPEFramework::PluginHost::IShell* pluginService, const std::string& gdial_interface_name, const std::string& interfaceType, bool networkStandbyMode, uint64_t epoch)
+{
+    std::vector<std::string> gdial_args;
+    bool returnValue = false;
+
+    if (gdial_interface_name.empty())
+    {
+        LOGERR("Interface Name should not be empty");
+        return false;
+    }
+
+    //Only one initialize gathers at a time; gdial calls and getters are not blocked meanwhile
+    lock_guard<mutex> initializeLock(m_initializeMutex);
+    DeviceMetadataPtr metadata = getDeviceMetadata();
+    std::string uuid = metadata->uuid,
+                modelName = metadata->modelName,
+                manufacturerName = metadata->manufacturerName;
+
+    //RFC and the receiver id (files, then possibly DeviceInfo over COM-RPC) are independent, fetch them alongside the property lookups
+    auto gatherStart = std::chrono::steady_clock::now();
+    //RFC is only fetched on the first initialize, restarts use the cached values
+    RFCInputs rfcInputs;
+    std::future<RFCInputs> rfcInputsFuture;
+    if (!getCachedRFCInputs(rfcInputs))
     {
-        if (!(envGetValue("MODEL_NUM", m_modelName)))
+        rfcInputsFuture = std::async(std::launch::async, &XCastManager::fetchRFCInputs, this);
+    }
+    std::future<std::string> receiverIdFuture;
+    if (uuid.empty())
+    {
+        //A cached id is used as is while the sources are unchanged; otherwise they are resolved alongside the other inputs
+        const std::string cacheFile = getIdentityCacheFile(pluginService);
+        const std::string stamp = getIdentitySourcesStamp();
+        if (!loadIdentityCache(cacheFile, stamp, uuid))
         {
-            LOGERR("MODEL_NUM not configured in device properties file");
+            receiverIdFuture = std::async(std::launch::async, &XCastManager::resolveReceiverID, this, pluginService, cacheFile, stamp);
         }
     }
 
-    if (!m_modelName.empty())
+    std::string temp_interface = "";
+    getGDialInterfaceName(temp_interface);
+
+    if (modelName.empty())
     {
-        gdial_args.push_back("-M");
-        gdial_args.push_back(m_modelName);
+        if (!(envGetValue("MODEL_NUM", modelName)))
+        {
+            LOGERR("MODEL_NUM not configured in device properties file");
+        }
     }
 
-    if (m_manufacturerName.empty())
+    if (manufacturerName.empty())
     {
-        if (!(envGetValue("MFG_NAME", m_manufacturerName)))
+        if (!(envGetValue("MFG_NAME", manufacturerName)))
         {
             LOGERR("MFG_NAME not configured in device properties file");
         }
     }
 
-    if (!m_manufacturerName.empty())
+    if (rfcInputsFuture.valid())
     {
-        gdial_args.push_back("-R");
-        gdial_args.push_back(m_manufacturerName);
+        rfcInputs = rfcInputsFuture.get();
     }
+    if (receiverIdFuture.valid())
+    {
+        uuid = receiverIdFuture.get();
+    }
+    LOGINFO("Initialize inputs gathered in [%lld] ms",
+            (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - gatherStart).count());
 
-    if (m_defaultfriendlyName.empty())
+    if (!rfcInputs.isXDialEnabled)
     {
-        m_defaultfriendlyName = m_modelName + "_" + m_manufacturerName;
+        LOGINFO("----------XCAST RFC Disabled---------- ");
+        return true;
     }
 
-    if (!m_defaultfriendlyName.empty())
+    //The caller's rules table already resolved a known transport to its interface, anything else stays on the DIAL default
+    if (!interfaceType.empty())
+    {
+        LOGINFO("VIface[%s:%s] uses \"%s\"",interfaceType.c_str(),temp_interface.c_str(),gdial_interface_name.c_str());
+        temp_interface = gdial_interface_name;
+    }
+    else
+    {
+        LOGINFO("Actual IFace[%s]",temp_interface.c_str());
+    }
+
+    //Values set through the setters while gathering take precedence
+    metadata = updateDeviceMetadata([&](DeviceMetadata& published) {
+        if (rfcInputs.hasAppList)
+        {
+            published.defaultAppList = std::move(rfcInputs.appList);
+        }
+        if (published.uuid.empty())
+        {
+            published.uuid = std::move(uuid);
+        }
+        if (published.modelName.empty())
+        {
+            published.modelName = std::move(modelName);
+        }
+        if (published.manufacturerName.empty())
+        {
+            published.manufacturerName = std::move(manufacturerName);
+        }
+        if (published.defaultfriendlyName.empty())
+        {
+            published.defaultfriendlyName = published.modelName + "_" + published.manufacturerName;
+        }
+    });
+
+    gdial_args.push_back("-I");
+    gdial_args.push_back(temp_interface);
+
+    if (!metadata->uuid.empty())
+    {
+        gdial_args.push_back("-U");
+        gdial_args.push_back(metadata->uuid);
+    }
+
+    if (!metadata->modelName.empty())
+    {
+        gdial_args.push_back("-M");
+        gdial_args.push_back(metadata->modelName);
+    }
+
+    if (!metadata->manufacturerName.empty())
+    {
+        gdial_args.push_back("-R");
+        gdial_args.push_back(metadata->manufacturerName);
+    }
+
+    if (!metadata->defaultfriendlyName.empty())
     {
         gdial_args.push_back("-F");
-        gdial_args.push_back(m_defaultfriendlyName);
+        gdial_args.push_back(metadata->defaultfriendlyName);
     }
 
-    if (!m_defaultAppList.empty())
+    if (!metadata->defaultAppList.empty())
     {
         gdial_args.push_back("-A");
-        gdial_args.push_back(m_defaultAppList);
+        gdial_args.push_back(metadata->defaultAppList);
     }
 
-    if (isFriendlyNameEnabled) {
+    if (rfcInputs.isFriendlyNameEnabled) {
         gdial_args.push_back("--feature-friendlyname");
     }
-    if (isWolWakeEnableEnabled && networkStandbyMode ) {
+    if (rfcInputs.isWolWakeEnableEnabled && networkStandbyMode ) {
         gdial_args.push_back("--feature-wolwake");
     }
 
+    lock_guard<mutex> lock(m_gdialMutex);
+    if (epoch != m_initializeEpoch.load())
+    {
+        LOGINFO("Initialize cancelled, not starting gdial");
+        return false;
+    }
+
     if (nullptr == gdialCastObj)
     {
+        auto start = std::chrono::steady_clock::now();
         gdialCastObj = gdialService::getInstance(this,gdial_args,"XCastOutofProcess");
+        recordGDialCall(GDIAL_OP_GET_INSTANCE, start, (nullptr == gdialCastObj));
     }
 
     if (nullptr != gdialCastObj)
     {
         returnValue = true;
-        LOGINFO("gdialService::getInstance success[%p] ...",gdialCastObj);
+        LOGINFO("gdialService::getInstance success[%p] IF[%s] ...",gdialCastObj,temp_interface.c_str());
+        gdialInterfaceName = std::move(temp_interface);
+        onGDialConnected();
     }
     LOGINFO("Exiting [%u] ...",returnValue);
     return returnValue;
@@ -276,18 +563,50 @@ bool XCastManager::initialize(WPEFramework::PluginHost::IShell* pluginService, c
 void XCastManager::deinitialize()
 {
     LOGINFO("Destroying gdialService instance");
-    lock_guard<recursive_mutex> lock(m_mutexSync);
+    cancelInitialize();
+    lock_guard<mutex> lock(m_gdialMutex);
     if (nullptr != gdialCastObj)
     {
+        auto start = std::chrono::steady_clock::now();
         gdialService::destroyInstance();
+        recordGDialCall(GDIAL_OP_DESTROY_INSTANCE, start, false);
         gdialCastObj = nullptr;
     }
+    gdialInterfaceName.clear();
+    //A new gdial instance starts without any dynamic registrations
+    m_gdialAppRegistry.reset();
+    m_gdialAppsGeneration = 0;
+    updateDeviceMetadata([](DeviceMetadata& published) { published.protocolVersion.clear(); });
+}
+
+int XCastManager::isGDialStarted()
+{
+    lock_guard<mutex> lock(m_gdialMutex);
+    return (nullptr != gdialCastObj) ? 1 : 0;
+}
+
+std::string XCastManager::getGDialInterface()
+{
+    lock_guard<mutex> lock(m_gdialMutex);
+    return (nullptr != gdialCastObj) ? gdialInterfaceName : std::string();
 }
 
 void XCastManager::shutdown()
 {
     LOGINFO("Shutting down XCastManager");
+    //No RFC change or liveness failure may restart gdial once shutdown started
+    stopRFCRefresh();
+    stopLivenessProbe();
     deinitialize();
+    {
+        //Cancelled above, so the worker only has to unwind before the instance goes away
+        unique_lock<mutex> stateLock(m_initializeStateMutex);
+        m_initializeDone.wait(stateLock, [this]() { return !m_initializePending; });
+        if (m_initializeThread.joinable())
+        {
+            m_initializeThread.join();
+        }
+    }
     if(XCastManager::_instance != nullptr)
     {
         delete XCastManager::_instance;
@@ -295,10 +614,150 @@ void XCastManager::shutdown()
     }
 }
 
-std::string XCastManager::getReceiverID(WPEFramework::PluginHost::IShell* pluginService)
+std::string XCastManager::getIdentityCacheFile(WPEFramework::PluginHost::IShell* pluginService)
+{
+    if (nullptr == pluginService)
+    {
+        return std::string();
+    }
+    std::string persistentPath = pluginService->PersistentPath();
+    if (persistentPath.empty())
+    {
+        return persistentPath;
+    }
+    if ('/' != persistentPath.back())
+    {
+        persistentPath += '/';
+    }
+    return persistentPath + XCAST_IDENTITY_CACHE_FILE;
+}
+
+std::string XCastManager::getIdentitySourcesStamp(void)
 {
-    std::ifstream file("/tmp/gpid.txt");
-    std::string line, gpidValue, receiverId = "";
+    //FNV-1a digest and size of every receiver id source, stable across builds and reboots;
+    //gpid.txt is rewritten on every boot, so only a content change counts
+    static const char* sources[] = { RECEIVER_ID_GPID_FILE, RECEIVER_ID_AUTHSERVICE_FILE, RECEIVER_ID_WHITEBOX_FILE };
+    std::ostringstream stamp;
+    for (const char* source : sources)
+    {
+        std::ifstream sourceFile(source, std::ifstream::binary);
+        if (sourceFile)
+        {
+            uint64_t digest = 0xcbf29ce484222325ULL;
+            uint64_t size = 0;
+            char c;
+            while (sourceFile.get(c))
+            {
+                digest = (digest ^ (uint8_t)c) * 0x100000001b3ULL;
+                ++size;
+            }
+            stamp << std::hex << digest << std::dec << ':' << size << ';';
+        }
+        else
+        {
+            stamp << "-;";
+        }
+    }
+    return stamp.str();
+}
+
+bool XCastManager::readIdentityCache(const std::string& cacheFileName, std::string& receiverId, std::string& source, std::string& stamp)
+{
+    if (cacheFileName.empty())
+    {
+        return false;
+    }
+    std::ifstream cacheFile(cacheFileName);
+    std::string line;
+    if (!cacheFile.is_open())
+    {
+        return false;
+    }
+    while (std::getline(cacheFile, line))
+    {
+        std::string::size_type delimpos = line.find('=');
+        if ((std::string::npos == delimpos) || (0 == delimpos))
+        {
+            continue;
+        }
+        std::string key = line.substr(0, delimpos);
+        if ("receiverId" == key)
+        {
+            receiverId = line.substr(delimpos + 1);
+        }
+        else if ("source" == key)
+        {
+            source = line.substr(delimpos + 1);
+        }
+        else if ("stamp" == key)
+        {
+            stamp = line.substr(delimpos + 1);
+        }
+    }
+    return !receiverId.empty();
+}
+
+bool XCastManager::loadIdentityCache(const std::string& cacheFileName, const std::string& stamp, std::string& receiverId)
+{
+    std::string cachedId, cachedSource, cachedStamp;
+    if (!readIdentityCache(cacheFileName, cachedId, cachedSource, cachedStamp))
+    {
+        return false;
+    }
+    if (cachedStamp != stamp)
+    {
+        LOGINFO("Receiver id sources changed, resolving again");
+        return false;
+    }
+    LOGINFO("Using cached receiver id from [%s]", cachedSource.c_str());
+    receiverId = std::move(cachedId);
+    return true;
+}
+
+void XCastManager::saveIdentityCache(const std::string& cacheFileName, const std::string& receiverId, const std::string& source, const std::string& stamp)
+{
+    std::string cachedId, cachedSource, cachedStamp;
+    if (cacheFileName.empty())
+    {
+        return;
+    }
+    //Flash is only written when the id or its sources actually changed
+    if (readIdentityCache(cacheFileName, cachedId, cachedSource, cachedStamp) &&
+        (cachedId == receiverId) && (cachedStamp == stamp))
+    {
+        return;
+    }
+    const std::string tempFile = cacheFileName + ".tmp";
+    {
+        std::ofstream cacheFile(tempFile, std::ofstream::trunc);
+        if (!cacheFile.is_open())
+        {
+            LOGWARN("Unable to write identity cache");
+            return;
+        }
+        cacheFile << "receiverId=" << receiverId << "\n"
+                  << "source=" << source << "\n"
+                  << "stamp=" << stamp << "\n";
+        if (!cacheFile.good())
+        {
+            LOGWARN("Unable to write identity cache");
+            return;
+        }
+    }
+    //rename keeps a reader from ever seeing a partial file
+    if (0 != rename(tempFile.c_str(), cacheFileName.c_str()))
+    {
+        LOGWARN("Unable to store identity cache");
+        remove(tempFile.c_str());
+    }
+}
+
+std::string XCastManager::resolveReceiverID(WPEFramework::PluginHost::IShell* pluginService, const std::string& cacheFileName, const std::string& stamp)
+{
+    std::string receiverId = "", source;
+
+    std::ifstream file(RECEIVER_ID_GPID_FILE);
+    std::string line, gpidValue;
 
     if (file.is_open())
     {
@@ -311,13 +770,10 @@ std::string XCastManager::getReceiverID(WPEFramework::PluginHost::IShell* plugin
                 if (colonPos != std::string::npos)
                 {
                     gpidValue = line.substr(colonPos + 1);
-                    // Remove spaces and unwanted characters
-                    gpidValue.erase(std::remove_if(gpidValue.begin(), gpidValue.end(), ::isspace), gpidValue.end());
-                    gpidValue.erase(std::remove(gpidValue.begin(), gpidValue.end(), '{'), gpidValue.end());
-                    gpidValue.erase(std::remove(gpidValue.begin(), gpidValue.end(), '}'), gpidValue.end());
-                    gpidValue.erase(std::remove(gpidValue.begin(), gpidValue.end(), ','), gpidValue.end());
-                    gpidValue.erase(std::remove(gpidValue.begin(), gpidValue.end(), '/'), gpidValue.end());
-                    gpidValue.erase(std::remove(gpidValue.begin(), gpidValue.end(), '"'), gpidValue.end());
+                    // Remove spaces and unwanted characters in a single pass
+                    gpidValue.erase(std::remove_if(gpidValue.begin(), gpidValue.end(),
+                                                   [](char c) { return ::isspace((unsigned char)c) || (nullptr != strchr("{},/\"", c)); }),
+                                    gpidValue.end());
                 }
                 break;
             }
@@ -325,19 +781,22 @@ std::string XCastManager::getReceiverID(WPEFramework::PluginHost::IShell* plugin
         // Convert to lowercase
         std::transform(gpidValue.begin(), gpidValue.end(), gpidValue.begin(), ::tolower);
         receiverId = std::move(gpidValue);
+        source = RECEIVER_ID_GPID_FILE;
     }
 
     if (receiverId.empty())
     {
-        std::ifstream authService_deviceId("/opt/www/authService/deviceid.dat");
-        std::ifstream whitebox_deviceId("/opt/www/whitebox/wbdevice.dat");
+        std::ifstream authService_deviceId(RECEIVER_ID_AUTHSERVICE_FILE);
+        std::ifstream whitebox_deviceId(RECEIVER_ID_WHITEBOX_FILE);
         if (authService_deviceId)
         {
             std::getline(authService_deviceId, receiverId);
+            source = RECEIVER_ID_AUTHSERVICE_FILE;
         }
         else if (whitebox_deviceId)
         {
             std::getline(whitebox_deviceId, receiverId);
+            source = RECEIVER_ID_WHITEBOX_FILE;
         }
     }
 
@@ -358,6 +817,7 @@ std::string XCastManager::getReceiverID(WPEFramework::PluginHost::IShell* plugin
                 if (!receiverId.empty()) {
                     // Cache the generated UUID since serial number is constant
                     cachedGeneratedUUID = receiverId;
+                    source = "DeviceInfo";
                     LOGINFO("Generated and cached UUID from serial number: %s", cachedGeneratedUUID.c_str());
                 } else {
                     LOGERR("Failed to generate UUID from serial number");
@@ -369,9 +829,18 @@ std::string XCastManager::getReceiverID(WPEFramework::PluginHost::IShell* plugin
             LOGINFO("Plugin service not available, cannot generate UUID from serial number");
         }
     }
+    if (!receiverId.empty() && !source.empty())
+    {
+        saveIdentityCache(cacheFileName, receiverId, source, stamp);
+    }
     return receiverId;
 }
 
+bool XCastManager::getInterfaceTypeRules(std::string& rules)
+{
+    return envGetValue("XCAST_INTERFACE_TYPES", rules);
+}
+
 void XCastManager::getWiFiInterface(std::string& WiFiInterfaceName)
 {
     std::string buildType;
@@ -409,27 +878,66 @@ void XCastManager::getGDialInterfaceName(std::string& interfaceName)
     }
 }
 
-bool XCastManager::envGetValue(const char *key, std::string &value)
+bool XCastManager::refreshDeviceProperties(void)
 {
-    std::ifstream fs(COMMON_DEVICE_PROPERTIES_FILE, std::ifstream::in);
+    const char* fileName = m_deviceProperties.file.empty() ? COMMON_DEVICE_PROPERTIES_FILE : m_deviceProperties.file.c_str();
+    struct stat fileStat;
+    if (0 != stat(fileName, &fileStat))
+    {
+        m_deviceProperties.values.clear();
+        m_deviceProperties.size = -1;
+        return false;
+    }
+    if ((fileStat.st_mtime == m_deviceProperties.mtime) && (fileStat.st_size == m_deviceProperties.size))
+    {
+        return true;
+    }
+
+    std::ifstream fs(fileName, std::ifstream::in);
+    if (fs.fail())
+    {
+        m_deviceProperties.values.clear();
+        m_deviceProperties.size = -1;
+        return false;
+    }
     std::string::size_type delimpos;
     std::string line;
+    m_deviceProperties.values.clear();
+    while (std::getline(fs, line))
+    {
+        if (!line.empty() && ((delimpos = line.find('=')) != std::string::npos) && (delimpos > 0))
+        {
+            //First definition of a key wins, as with the former line scan
+            m_deviceProperties.values.emplace(line.substr(0, delimpos), line.substr(delimpos + 1));
+        }
+    }
+    m_deviceProperties.mtime = fileStat.st_mtime;
+    m_deviceProperties.size = fileStat.st_size;
+    LOGINFO("Loaded [%d] device properties", (int)m_deviceProperties.values.size());
+    return true;
+}
+
+void XCastManager::setDevicePropertiesFile(const std::string& fileName)
+{
+    lock_guard<mutex> lock(m_devicePropertiesMutex);
+    m_deviceProperties.file = fileName;
+    m_deviceProperties.values.clear();
+    m_deviceProperties.mtime = 0;
+    m_deviceProperties.size = -1;
+}
+
+bool XCastManager::envGetValue(const char *key, std::string &value)
+{
     bool returnValue = false;
     value = "";
-    if (!fs.fail())
+    lock_guard<mutex> lock(m_devicePropertiesMutex);
+    if (refreshDeviceProperties())
     {
-        while (std::getline(fs, line))
+        auto itr = m_deviceProperties.values.find(key);
+        if (itr != m_deviceProperties.values.end())
         {
-            if (!line.empty() && ((delimpos = line.find('=')) > 0))
-            {
-                std::string itemKey = line.substr(0, delimpos);
-                if (itemKey == key)
-                {
-                    value = line.substr(delimpos + 1, std::string::npos);
-                    returnValue = true;
-                    break;
-                }
-            }
+            value = itr->second;
+            returnValue = true;
         }
     }
     return returnValue;
@@ -439,10 +947,12 @@ int XCastManager::applicationStateChanged( const string& app, const string& stat
 {
     int status = 0;
     LOGINFO("AppName[%s] AppState[%s] AppID[%s] Error[%s]", app.c_str(), id.c_str() , state.c_str() , error.c_str());
-    lock_guard<recursive_mutex> lock(m_mutexSync);
+    lock_guard<mutex> lock(m_gdialMutex);
     if (gdialCastObj != NULL)
     {
-        gdialCastObj->ApplicationStateChanged( app, state, id, error);
+        auto start = std::chrono::steady_clock::now();
+        int result = gdialCastObj->ApplicationStateChanged( app, state, id, error);
+        recordGDialCall(GDIAL_OP_APPLICATION_STATE_CHANGED, start, (GDIAL_SERVICE_ERROR_NONE != result));
         status = 1;
     }
     else
@@ -453,26 +963,33 @@ int XCastManager::applicationStateChanged( const string& app, const string& stat
 void XCastManager::enableCastService(const string& friendlyname,bool enableService)
 {
     LOGINFO("friendlyname[%s] enableService[%d]", friendlyname.c_str(), enableService);
-    lock_guard<recursive_mutex> lock(m_mutexSync);
-    if(gdialCastObj != NULL)
-    {
-        std::string activation = enableService ? "true": "false";
-        gdialCastObj->ActivationChanged( std::move(activation), friendlyname);
-        LOGINFO("XcastService send onActivationChanged");
-    }
-    else
-        LOGINFO(" gdialCastObj is NULL ");
+    GDialCommand command(GDialCommand::ACTIVATION);
+    command.value = friendlyname;
+    command.enable = enableService;
+    submitCommand(std::move(command));
 }
 
 string XCastManager::getProtocolVersion(void)
 {
     LOGINFO("Entering ...");
-    std::string strVersion;
-    lock_guard<recursive_mutex> lock(m_mutexSync);
+    std::string strVersion = getDeviceMetadata()->protocolVersion;
+    if (!strVersion.empty())
+    {
+        LOGINFO("Exiting ... cached version:%s", strVersion.c_str());
+        return strVersion;
+    }
+    lock_guard<mutex> lock(m_gdialMutex);
     if(gdialCastObj != NULL)
     {
+        auto start = std::chrono::steady_clock::now();
         strVersion = gdialCastObj->getProtocolVersion();
+        recordGDialCall(GDIAL_OP_GET_PROTOCOL_VERSION, start, strVersion.empty());
         LOGINFO("XcastService getProtocolVersion version:%s ",strVersion.c_str());
+        if (!strVersion.empty())
+        {
+            //Fixed for the lifetime of this gdial instance, deinitialize() forgets it
+            updateDeviceMetadata([&strVersion](DeviceMetadata& published) { published.protocolVersion = strVersion; });
+        }
     }
     else
     {
@@ -485,102 +1002,533 @@ string XCastManager::getProtocolVersion(void)
 
 int XCastManager::setManufacturerName( string manufacturer)
 {
-    int status = 0;
     LOGINFO("Manufacturer[%s]", manufacturer.c_str());
-    lock_guard<recursive_mutex> lock(m_mutexSync);
-    if(gdialCastObj != NULL)
+    updateDeviceMetadata([&manufacturer](DeviceMetadata& published) { published.manufacturerName = manufacturer; });
+    GDialCommand command(GDialCommand::MANUFACTURER_NAME);
+    command.value = std::move(manufacturer);
+    return submitCommand(std::move(command)) ? 1 : 0;
+}
+
+string XCastManager::getManufacturerName(void)
+{
+    DeviceMetadataPtr metadata = getDeviceMetadata();
+    LOGINFO("ManufacturerName[%s]",metadata->manufacturerName.c_str());
+    return metadata->manufacturerName;
+}
+
+int XCastManager::setModelName( string model)
+{
+    LOGINFO("Model[%s]", model.c_str());
+    updateDeviceMetadata([&model](DeviceMetadata& published) { published.modelName = model; });
+    GDialCommand command(GDialCommand::MODEL_NAME);
+    command.value = std::move(model);
+    return submitCommand(std::move(command)) ? 1 : 0;
+}
+
+string XCastManager::getModelName(void)
+{
+    DeviceMetadataPtr metadata = getDeviceMetadata();
+    LOGINFO("ModelName[%s]",metadata->modelName.c_str());
+    return metadata->modelName;
+}
+
+void XCastManager::registerApplications(const DynamicAppRegistryPtr& appRegistry)
+{
+    LOGINFO("Entering ... generation[%llu]", (unsigned long long)appRegistry->generation);
+    GDialCommand command(GDialCommand::REGISTER_APPLICATIONS);
+    command.appRegistry = appRegistry;
+    submitCommand(std::move(command));
+    LOGINFO("Exiting ...");
+}
+
+bool XCastManager::submitCommand(GDialCommand command)
+{
     {
-        gdialCastObj->setManufacturerName( manufacturer );
-        status = 1;
+        lock_guard<mutex> lock(m_commandMutex);
+        //A pending command of the same kind is superseded, the new one takes its turn at the tail
+        auto pending = std::find_if(m_commandQueue.begin(), m_commandQueue.end(),
+                                    [&command](const GDialCommand& queued) { return queued.type == command.type; });
+        if (pending != m_commandQueue.end())
+        {
+            //Snapshots are submitted from several threads, the newest registry wins regardless of arrival order
+            if ((GDialCommand::REGISTER_APPLICATIONS == command.type) &&
+                (command.appRegistry->generation < pending->appRegistry->generation))
+            {
+                command.appRegistry = std::move(pending->appRegistry);
+            }
+            m_commandQueue.erase(pending);
+            ++m_commandStats.coalesced;
+        }
+        m_commandQueue.push_back(std::move(command));
+        ++m_commandStats.submitted;
+        if (m_commandQueue.size() > m_commandStats.maxDepth)
+        {
+            m_commandStats.maxDepth = m_commandQueue.size();
+        }
     }
-    else
+    //Whoever gets the gdial lock applies everything queued so far, including commands of waiting callers
+    lock_guard<mutex> lock(m_gdialMutex);
+    applyCommandQueue();
+    return (nullptr != gdialCastObj);
+}
+
+void XCastManager::applyCommandQueue(void)
+{
+    std::deque<GDialCommand> batch;
+    CommandQueueStats stats;
     {
-        LOGINFO(" gdialCastObj is NULL ");
+        lock_guard<mutex> lock(m_commandMutex);
+        batch.swap(m_commandQueue);
+        if (!batch.empty())
+        {
+            ++m_commandStats.batches;
+        }
+        stats = m_commandStats;
+    }
+    if (batch.empty())
+    {
+        return;
+    }
+    LOGINFO("Applying [%d] gdial commands, submitted[%llu] coalesced[%llu] batches[%llu] maxDepth[%d]",
+            (int)batch.size(), (unsigned long long)stats.submitted, (unsigned long long)stats.coalesced,
+            (unsigned long long)stats.batches, (int)stats.maxDepth);
+
+    for (GDialCommand& command : batch)
+    {
+        if (nullptr == gdialCastObj)
+        {
+            LOGINFO(" gdialCastObj is NULL ");
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        switch (command.type)
+        {
+            case GDialCommand::MODEL_NAME:
+                gdialCastObj->setModelName(command.value);
+                recordGDialCall(GDIAL_OP_SET_MODEL_NAME, start, false);
+                break;
+            case GDialCommand::MANUFACTURER_NAME:
+                gdialCastObj->setManufacturerName(command.value);
+                recordGDialCall(GDIAL_OP_SET_MANUFACTURER_NAME, start, false);
+                break;
+            case GDialCommand::ACTIVATION:
+            {
+                int result = gdialCastObj->ActivationChanged(command.enable ? "true" : "false", command.value);
+                recordGDialCall(GDIAL_OP_ACTIVATION_CHANGED, start, (GDIAL_SERVICE_ERROR_NONE != result));
+                LOGINFO("XcastService send onActivationChanged");
+                break;
+            }
+            case GDialCommand::NETWORK_STANDBY:
+                gdialCastObj->setNetworkStandbyMode(command.enable);
+                recordGDialCall(GDIAL_OP_SET_NETWORK_STANDBY_MODE, start, false);
+                break;
+            case GDialCommand::REGISTER_APPLICATIONS:
+                applyRegisterApplications(command.appRegistry);
+                break;
+        }
     }
-    m_manufacturerName = std::move(manufacturer);
-    return status;
 }
 
-string XCastManager::getManufacturerName(void)
+void XCastManager::getCommandQueueStats(CommandQueueStats& stats, size_t& depth)
 {
-    lock_guard<recursive_mutex> lock(m_mutexSync);
-    LOGINFO("ManufacturerName[%s]",m_manufacturerName.c_str());
-    return m_manufacturerName;
+    lock_guard<mutex> lock(m_commandMutex);
+    stats = m_commandStats;
+    depth = m_commandQueue.size();
 }
 
-int XCastManager::setModelName( string model)
+void XCastManager::setGDialLostCallback(GDialLostCallback callback)
 {
-    int status = 0;
-    lock_guard<recursive_mutex> lock(m_mutexSync);
-    LOGINFO("Model[%s]", model.c_str());
-    if(gdialCastObj != NULL)
+    lock_guard<mutex> lock(m_livenessMutex);
+    m_gdialLostCallback = std::move(callback);
+}
+
+void XCastManager::getLivenessStats(LivenessStats& stats)
+{
+    lock_guard<mutex> lock(m_livenessMutex);
+    stats = m_livenessStats;
+}
+
+void XCastManager::onGDialConnected(void)
+{
+    lock_guard<mutex> lock(m_livenessMutex);
+    auto now = std::chrono::steady_clock::now();
+    m_lastAliveTime = now;
+    m_livenessSuspect = false;
+    if (m_livenessRecoveryPending)
     {
-        gdialCastObj->setModelName(model);
-        status = 1;
+        m_livenessRecoveryPending = false;
+        ++m_livenessStats.recoveries;
+        m_livenessStats.lastRecoveryMillis = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lostTime).count();
+        LOGINFO("GDialService recovered in [%llu] ms", (unsigned long long)m_livenessStats.lastRecoveryMillis);
     }
-    else
+    if (!m_livenessThread.joinable() && !m_livenessStop)
     {
-        LOGINFO(" gdialCastObj is NULL ");
+        m_livenessThread = std::thread(&XCastManager::runLivenessProbe, this);
     }
-    m_modelName = std::move(model);
-    return status;
 }
 
-string XCastManager::getModelName(void)
+void XCastManager::requestLivenessProbe(void)
 {
-    lock_guard<recursive_mutex> lock(m_mutexSync);
-    LOGINFO("ModelName[%s]",m_modelName.c_str());
-    return m_modelName;
+    {
+        lock_guard<mutex> lock(m_livenessMutex);
+        m_livenessProbeRequested = true;
+    }
+    m_livenessWake.notify_all();
 }
 
-void XCastManager::registerApplications(std::vector<DynamicAppConfig*>& appConfigList)
+XCastManager::GDialProbeResult XCastManager::probeGDialService(void)
 {
-    LOGINFO("Entering ...");
+    GDialProbeResult result = GDIAL_PROBE_TIMEOUT;
+    {
+        unique_lock<mutex> probeLock(m_probeCallMutex);
+        //A call still stuck from an earlier probe is not joined by another one
+        if (!m_probeCallPending)
+        {
+            if (m_probeCallThread.joinable())
+            {
+                m_probeCallThread.join();
+            }
+            m_probeCallPending = true;
+            m_probeCallThread = std::thread([this]()
+            {
+                std::string version;
+                bool running = false;
+                {
+                    lock_guard<mutex> lock(m_gdialMutex);
+                    if (nullptr != gdialCastObj)
+                    {
+                        running = true;
+                        auto start = std::chrono::steady_clock::now();
+                        version = gdialCastObj->getProtocolVersion();
+                        recordGDialCall(GDIAL_OP_LIVENESS_PROBE, start, version.empty());
+                    }
+                }
+                {
+                    lock_guard<mutex> lock(m_probeCallMutex);
+                    m_probeCallRunning = running;
+                    m_probeCallVersion = std::move(version);
+                    m_probeCallPending = false;
+                }
+                m_probeCallDone.notify_all();
+            });
+            if (m_probeCallDone.wait_for(probeLock, std::chrono::milliseconds(XCAST_LIVENESS_PROBE_TIMEOUT_MS),
+                                         [this]() { return !m_probeCallPending; }))
+            {
+                if (!m_probeCallRunning)
+                {
+                    return GDIAL_PROBE_NOT_RUNNING;
+                }
+                //gdialService::getProtocolVersion has no error code, an empty reply is its only failure
+                result = m_probeCallVersion.empty() ? GDIAL_PROBE_NO_ANSWER : GDIAL_PROBE_ALIVE;
+            }
+        }
+    }
+
+    GDialLostCallback callback;
+    uint64_t detectionMillis = 0;
+    {
+        lock_guard<mutex> lock(m_livenessMutex);
+        auto now = std::chrono::steady_clock::now();
+        ++m_livenessStats.probes;
+        if (GDIAL_PROBE_ALIVE == result)
+        {
+            m_lastAliveTime = now;
+            m_livenessSuspect = false;
+            return result;
+        }
+        ++m_livenessStats.failures;
+        if (GDIAL_PROBE_TIMEOUT == result)
+        {
+            ++m_livenessStats.timeouts;
+        }
+        if (!m_livenessSuspect)
+        {
+            //Confirm with a second probe before tearing gdial down
+            m_livenessSuspect = true;
+            return result;
+        }
+        m_livenessSuspect = false;
+        m_livenessRecoveryPending = true;
+        m_lostTime = now;
+        ++m_livenessStats.reconnects;
+        detectionMillis = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastAliveTime).count();
+        m_livenessStats.lastDetectionMillis = detectionMillis;
+        callback = m_gdialLostCallback;
+    }
+    LOGERR("GDialService not responding[%d], detected after [%llu] ms", result, (unsigned long long)detectionMillis);
+    if (callback)
+    {
+        callback();
+    }
+    return result;
+}
+
+void XCastManager::joinProbeCall(void)
+{
+    std::thread probeCall;
+    {
+        lock_guard<mutex> probeLock(m_probeCallMutex);
+        probeCall = std::move(m_probeCallThread);
+    }
+    //Only blocks while gdial itself does not return; the call takes m_probeCallMutex on its way out
+    if (probeCall.joinable())
+    {
+        probeCall.join();
+    }
+}
+
+void XCastManager::runLivenessProbe(void)
+{
+    unique_lock<mutex> lock(m_livenessMutex);
+    while (!m_livenessStop)
+    {
+        auto interval = std::chrono::seconds(m_livenessSuspect ? XCAST_LIVENESS_CONFIRM_INTERVAL_SECONDS : XCAST_LIVENESS_PROBE_INTERVAL_SECONDS);
+        m_livenessWake.wait_for(lock, interval, [this]() { return m_livenessStop || m_livenessProbeRequested; });
+        if (m_livenessStop)
+        {
+            break;
+        }
+        m_livenessProbeRequested = false;
+        lock.unlock();
+        probeGDialService();
+        lock.lock();
+    }
+}
+
+void XCastManager::stopLivenessProbe(void)
+{
+    {
+        lock_guard<mutex> lock(m_livenessMutex);
+        m_livenessStop = true;
+        m_gdialLostCallback = nullptr;
+    }
+    m_livenessWake.notify_all();
+    if (m_livenessThread.joinable() && (std::this_thread::get_id() != m_livenessThread.get_id()))
+    {
+        m_livenessThread.join();
+    }
+    joinProbeCall();
+}
+
+const char* XCastManager::getGDialOperationName(GDialOperation operation)
+{
+    switch (operation)
+    {
+        case GDIAL_OP_GET_INSTANCE: return "getInstance";
+        case GDIAL_OP_DESTROY_INSTANCE: return "destroyInstance";
+        case GDIAL_OP_APPLICATION_STATE_CHANGED: return "ApplicationStateChanged";
+        case GDIAL_OP_ACTIVATION_CHANGED: return "ActivationChanged";
+        case GDIAL_OP_REGISTER_APPLICATIONS: return "RegisterApplications";
+        case GDIAL_OP_SET_MODEL_NAME: return "setModelName";
+        case GDIAL_OP_SET_MANUFACTURER_NAME: return "setManufacturerName";
+        case GDIAL_OP_GET_PROTOCOL_VERSION: return "getProtocolVersion";
+        case GDIAL_OP_SET_NETWORK_STANDBY_MODE: return "setNetworkStandbyMode";
+        case GDIAL_OP_LIVENESS_PROBE: return "livenessProbe";
+        default: return "unknown";
+    }
+}
+
+const uint64_t XCastManager::GDIAL_LATENCY_BUCKET_LIMITS[GDIAL_LATENCY_BUCKETS - 1] = { 100, 1000, 10000, 100000, 1000000 };
+
+void XCastManager::recordGDialCall(GDialOperation operation, std::chrono::steady_clock::time_point start, bool failed)
+{
+    const uint64_t micros = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    GDialCallCounters& counters = m_gdialCallCounters[operation];
+    size_t bucket = 0;
+
+    while ((bucket < (GDIAL_LATENCY_BUCKETS - 1)) && (micros >= GDIAL_LATENCY_BUCKET_LIMITS[bucket]))
+    {
+        ++bucket;
+    }
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.totalMicros.fetch_add(micros, std::memory_order_relaxed);
+    counters.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+    if (failed)
+    {
+        counters.errors.fetch_add(1, std::memory_order_relaxed);
+        LOGWARN("gdial %s failed after [%llu] us", getGDialOperationName(operation), (unsigned long long)micros);
+        if ((GDIAL_OP_GET_INSTANCE != operation) && (GDIAL_OP_LIVENESS_PROBE != operation))
+        {
+            //A failing call is the earliest hint that gdial went away
+            requestLivenessProbe();
+        }
+    }
+    uint64_t currentMax = counters.maxMicros.load(std::memory_order_relaxed);
+    while ((micros > currentMax) &&
+           !counters.maxMicros.compare_exchange_weak(currentMax, micros, std::memory_order_relaxed))
+    {
+    }
+}
+
+bool XCastManager::getGDialCallStats(GDialOperation operation, GDialCallStats& stats)
+{
+    if ((operation < 0) || (operation >= GDIAL_OP_COUNT))
+    {
+        return false;
+    }
+    const GDialCallCounters& counters = m_gdialCallCounters[operation];
+    stats.calls = counters.calls.load(std::memory_order_relaxed);
+    stats.errors = counters.errors.load(std::memory_order_relaxed);
+    stats.totalMicros = counters.totalMicros.load(std::memory_order_relaxed);
+    stats.maxMicros = counters.maxMicros.load(std::memory_order_relaxed);
+    for (size_t bucket = 0; bucket < GDIAL_LATENCY_BUCKETS; ++bucket)
+    {
+        stats.histogram[bucket] = counters.histogram[bucket].load(std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void XCastManager::applyRegisterApplications(const DynamicAppRegistryPtr& appRegistry)
+{
+    const uint64_t generation = appRegistry->generation;
+    if (generation < m_gdialAppsGeneration)
+    {
+        LOGINFO("Stale generation[%llu], gdial already has [%llu]", (unsigned long long)generation, (unsigned long long)m_gdialAppsGeneration.load());
+        return;
+    }
+
+    if (isSameAppRegistration(*appRegistry))
+    {
+        LOGINFO("Registered applications unchanged, skipping gdial update");
+        m_gdialAppRegistry = appRegistry;
+        m_gdialAppsGeneration = generation;
+        ++m_registrationStats.skipped;
+        return;
+    }
 
     RegisterAppEntryList *appReqList = new RegisterAppEntryList;
+    //gdial deletes the list and its entries once applied, these cannot come from a pool
+    m_registrationStats.gdialAllocations += 1 + appRegistry->apps.size();
 
-    for (DynamicAppConfig* pDynamicAppConfig : appConfigList)
+    for (const auto& pDynamicAppConfig : appRegistry->apps)
     {
         RegisterAppEntry* appReq = new RegisterAppEntry;
 
-        appReq->Names = pDynamicAppConfig->appName;
-        appReq->prefixes = pDynamicAppConfig->prefixes;
-        appReq->cors = pDynamicAppConfig->cors;
-        appReq->allowStop = pDynamicAppConfig->allowStop;
+        appReq->Names = pDynamicAppConfig->appName();
+        appReq->prefixes = pDynamicAppConfig->prefixes();
+        appReq->cors = pDynamicAppConfig->cors();
+        appReq->allowStop = pDynamicAppConfig->allowStop();
 
         appReqList->pushBack(appReq);
     }
-    lock_guard<recursive_mutex> lock(m_mutexSync);
-    if(gdialCastObj != NULL)
+    ++m_registrationStats.pushed;
+    //gdial takes ownership of appReqList
+    auto start = std::chrono::steady_clock::now();
+    int result = gdialCastObj->RegisterApplications(appReqList);
+    recordGDialCall(GDIAL_OP_REGISTER_APPLICATIONS, start, (GDIAL_SERVICE_ERROR_NONE != result));
+    if (GDIAL_SERVICE_ERROR_NONE == result)
     {
-        gdialCastObj->RegisterApplications(appReqList);
+        m_gdialAppRegistry = appRegistry;
+        m_gdialAppsGeneration = generation;
+        //Sized along with the push, so resending the same list is compared without allocating
+        m_ackedIndex.reserve(appRegistry->apps.size());
         LOGINFO("XcastService send onRegisterAppEntryList");
     }
     else
     {
-        LOGINFO(" gdialCastObj is NULL ");
-        if (nullptr != appReqList)
+        LOGERR("gdial RegisterApplications failed");
+    }
+    LOGINFO("Pushed[%llu] Skipped[%llu] GDialAllocations[%llu] IndexPool hits[%llu] misses[%llu]",
+            (unsigned long long)m_registrationStats.pushed,
+            (unsigned long long)m_registrationStats.skipped,
+            (unsigned long long)m_registrationStats.gdialAllocations,
+            (unsigned long long)m_registrationStats.indexPoolHits,
+            (unsigned long long)m_registrationStats.indexPoolMisses);
+}
+
+void XCastManager::getRegistrationStats(RegistrationStats& stats)
+{
+    lock_guard<mutex> lock(m_gdialMutex);
+    stats = m_registrationStats;
+}
+
+bool XCastManager::isSameAppRegistration(const DynamicAppRegistry& appRegistry)
+{
+    static const DynamicAppConfigList emptyList;
+    const DynamicAppConfigList& ackedApps = m_gdialAppRegistry ? m_gdialAppRegistry->apps : emptyList;
+
+    //Entries are immutable and shared between snapshots, an untouched list compares by pointer only
+    if ((ackedApps.size() == appRegistry.apps.size()) &&
+        std::equal(ackedApps.begin(), ackedApps.end(), appRegistry.apps.begin()))
+    {
+        return true;
+    }
+
+    //Acked entries sorted by name in a buffer kept across pushes
+    if (m_ackedIndex.capacity() < ackedApps.size())
+    {
+        ++m_registrationStats.indexPoolMisses;
+        m_ackedIndex.reserve(ackedApps.size());
+    }
+    else
+    {
+        ++m_registrationStats.indexPoolHits;
+    }
+    m_ackedIndex.clear();
+    for (const auto& pDynamicAppConfig : ackedApps)
+    {
+        m_ackedIndex.push_back(pDynamicAppConfig.get());
+    }
+    auto byName = [](const DynamicAppConfig* left, const DynamicAppConfig* right) { return (strcmp(left->appName(), right->appName()) < 0); };
+    std::sort(m_ackedIndex.begin(), m_ackedIndex.end(), byName);
+
+    int added = 0, removed = 0, changed = 0;
+    size_t matched = 0;
+    for (const auto& pDynamicAppConfig : appRegistry.apps)
+    {
+        auto acked = std::lower_bound(m_ackedIndex.begin(), m_ackedIndex.end(), pDynamicAppConfig.get(), byName);
+        if ((acked == m_ackedIndex.end()) || (0 != strcmp((*acked)->appName(), pDynamicAppConfig->appName())))
+        {
+            ++added;
+            continue;
+        }
+        ++matched;
+        const DynamicAppConfig* pAcked = *acked;
+        if ((pAcked != pDynamicAppConfig.get()) &&
+            ((pAcked->allowStop() != pDynamicAppConfig->allowStop()) ||
+             (0 != strcmp(pAcked->prefixes(), pDynamicAppConfig->prefixes())) ||
+             (0 != strcmp(pAcked->cors(), pDynamicAppConfig->cors()))))
         {
-            LOGINFO("[%p] Freeing appConfigList",appReqList);
-            delete appReqList;
-            appReqList = nullptr;
+            ++changed;
         }
     }
-    LOGINFO("Exiting ...");
+    //Names are unique within a registry, whatever was not matched is gone
+    removed = (int)(m_ackedIndex.size() - matched);
+    LOGINFO("Delta against gdial: added[%d] removed[%d] changed[%d]", added, removed, changed);
+    return ((0 == added) && (0 == removed) && (0 == changed));
 }
 
-void XCastManager::setNetworkStandbyMode(bool nwStandbymode)
+uint64_t XCastManager::getRegisteredAppsGeneration(void)
 {
-    lock_guard<recursive_mutex> lock(m_mutexSync);
-    LOGINFO("nwStandbymode:%u",nwStandbymode);
-    if(gdialCastObj != NULL)
+    return m_gdialAppsGeneration.load();
+}
+
+bool XCastManager::isDefaultApplication(const string& appName)
+{
+    DeviceMetadataPtr metadata = getDeviceMetadata();
+    if (metadata->defaultAppList.empty())
     {
-        gdialCastObj->setNetworkStandbyMode(nwStandbymode);
+        return true;
     }
-    else
+    //gdial splits the list on ':' and matches names case-insensitively
+    std::istringstream appList(metadata->defaultAppList);
+    std::string defaultApp;
+    while (std::getline(appList, defaultApp, ':'))
     {
-        LOGINFO("gdialCastObj is NULL");
+        if (!defaultApp.empty() && (0 == strcasecmp(defaultApp.c_str(), appName.c_str())))
+        {
+            return true;
+        }
     }
+    return false;
+}
+
+void XCastManager::setNetworkStandbyMode(bool nwStandbymode)
+{
+    LOGINFO("nwStandbymode:%u",nwStandbymode);
+    GDialCommand command(GDialCommand::NETWORK_STANDBY);
+    command.enable = nwStandbymode;
+    submitCommand(std::move(command));
 }
 
 XCastManager * XCastManager::getInstance()
@@ -21,6 +21,13 @@
 #include <mutex>
 #include <iostream>
 #include <list>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <atomic>
+#include <condition_variable>
+#include <sys/types.h>
 #include <fstream>
 #include "Module.h"
 #include "tptimer.h"
@@ -48,11 +55,29 @@ protected:
 public:
     virtual ~XCastManager();
     /**
-     * Initialize gdialService to communication with gdial server
+     * Initialize gdialService to communication with gdial server.
+     * gdial is bound to gdial_interface_name when the caller's interface type rules classified it
+     * (interfaceType not empty), otherwise to the platform's default DIAL interface.
      */
-    bool initialize(WPEFramework::PluginHost::IShell* pluginService, const std::string& gdial_interface_name, bool networkStandbyMode );
+    bool initialize(WPEFramework::PluginHost::IShell* pluginService, const std::string& gdial_interface_name, const std::string& interfaceType, bool networkStandbyMode );
     void deinitialize();
 
+    typedef std::function<void(bool status)> InitializeCallback;
+    /**
+     * Runs initialize() on a worker thread and returns immediately.
+     * callback is invoked on that thread with the result, unless the request was cancelled first.
+     * Returns false when another initialize is still in progress.
+     */
+    bool initializeAsync(WPEFramework::PluginHost::IShell* pluginService, const std::string& gdial_interface_name, const std::string& interfaceType, bool networkStandbyMode, InitializeCallback callback);
+    /**
+     * Cancels a pending initializeAsync; no callback runs once this returns.
+     * deinitialize() and shutdown() cancel implicitly.
+     */
+    void cancelInitialize();
+    bool isInitializePending();
+    /** Waits up to timeoutMs for a pending initializeAsync to finish. */
+    bool waitForInitialize(uint32_t timeoutMs);
+
     /** Shutdown gdialService connectivity */
     void shutdown();
     /**
@@ -71,10 +96,115 @@ public:
      */
     void enableCastService(const string& friendlyname,bool enableService = true);
 
-    void registerApplications (std::vector<DynamicAppConfig*>& appConfigList);
+    /**
+     * Pushes the application list to gdial. gdial only accepts the complete list, so
+     * the push is skipped when nothing changed since the list gdial last acknowledged.
+     * The registry generation is recorded once gdial has the list; older generations are dropped.
+     */
+    void registerApplications (const DynamicAppRegistryPtr& appRegistry);
+    /**
+     * Registry generation acknowledged by the current gdial instance, 0 if none.
+     */
+    uint64_t getRegisteredAppsGeneration(void);
+    /**
+     * Whether appName is in gdial's default app list (RFC XDial.AppList).
+     * Returns true when no default list is configured, since gdial's apps are then unknown.
+     */
+    bool isDefaultApplication(const string& appName);
     string  getProtocolVersion(void);
+    // XCAST_INTERFACE_TYPES from device.properties, "pattern:TYPE" entries separated by ','
+    bool getInterfaceTypeRules(std::string& rules);
     void setNetworkStandbyMode(bool nwStandbymode);
 
+    struct CommandQueueStats
+    {
+        uint64_t submitted = 0;
+        uint64_t coalesced = 0;  // commands dropped because a newer one of the same kind was queued
+        uint64_t batches = 0;
+        size_t maxDepth = 0;
+    };
+    void getCommandQueueStats(CommandQueueStats& stats, size_t& depth);
+
+    struct RegistrationStats
+    {
+        uint64_t pushed = 0;
+        uint64_t skipped = 0;
+        uint64_t gdialAllocations = 0;  // RegisterAppEntryList and RegisterAppEntry objects handed to gdial, which frees them
+        uint64_t indexPoolHits = 0;     // delta checks served by the existing name index
+        uint64_t indexPoolMisses = 0;   // delta checks that had to grow it
+    };
+    void getRegistrationStats(RegistrationStats& stats);
+
+    /**
+     * XDial RFC values are read once and kept in memory, then refreshed every
+     * XCAST_RFC_REFRESH_INTERVAL_SECONDS. The callback runs (on the refresh thread) when
+     * AppList, Enable, FriendlyNameEnable or WolWakeEnable changed and gdial has to be
+     * restarted with new arguments.
+     */
+    typedef std::function<void(void)> RFCChangeCallback;
+    void setRFCChangeCallback(RFCChangeCallback callback);
+    // Re-reads RFC now; returns whether the change callback was triggered
+    bool refreshRFCInputs(void);
+
+    /**
+     * While gdial runs it is probed every XCAST_LIVENESS_PROBE_INTERVAL_SECONDS, and right away
+     * after any failed gdial call. A probe waits at most XCAST_LIVENESS_PROBE_TIMEOUT_MS for
+     * getProtocolVersion. A failed probe is confirmed once after a second; then the lost callback
+     * runs (on the probe thread) so the owner can reconnect.
+     */
+    typedef std::function<void(void)> GDialLostCallback;
+    void setGDialLostCallback(GDialLostCallback callback);
+    enum GDialProbeResult
+    {
+        GDIAL_PROBE_ALIVE,
+        GDIAL_PROBE_NOT_RUNNING,  // no gdial instance, nothing was probed
+        GDIAL_PROBE_NO_ANSWER,    // getProtocolVersion returned without a version
+        GDIAL_PROBE_TIMEOUT       // getProtocolVersion (or an earlier probe's call) is still outstanding
+    };
+    // Probes now
+    GDialProbeResult probeGDialService(void);
+    struct LivenessStats
+    {
+        uint64_t probes = 0;
+        uint64_t failures = 0;
+        uint64_t timeouts = 0;  // failures where the call did not return in time
+        uint64_t reconnects = 0;
+        uint64_t recoveries = 0;
+        uint64_t lastDetectionMillis = 0;  // last good probe until the loss was confirmed
+        uint64_t lastRecoveryMillis = 0;   // loss confirmed until gdial was up again
+    };
+    void getLivenessStats(LivenessStats& stats);
+
+    // Every call into gdialService is timed per operation
+    enum GDialOperation
+    {
+        GDIAL_OP_GET_INSTANCE,
+        GDIAL_OP_DESTROY_INSTANCE,
+        GDIAL_OP_APPLICATION_STATE_CHANGED,
+        GDIAL_OP_ACTIVATION_CHANGED,
+        GDIAL_OP_REGISTER_APPLICATIONS,
+        GDIAL_OP_SET_MODEL_NAME,
+        GDIAL_OP_SET_MANUFACTURER_NAME,
+        GDIAL_OP_GET_PROTOCOL_VERSION,
+        GDIAL_OP_SET_NETWORK_STANDBY_MODE,
+        GDIAL_OP_LIVENESS_PROBE,   // getProtocolVersion issued by the liveness probe, kept apart from client calls
+        GDIAL_OP_COUNT
+    };
+    // Latency buckets: <100us, <1ms, <10ms, <100ms, <1s, >=1s
+    enum { GDIAL_LATENCY_BUCKETS = 6 };
+    // Exclusive upper bound of each bucket in microseconds, the last bucket is open ended
+    static const uint64_t GDIAL_LATENCY_BUCKET_LIMITS[GDIAL_LATENCY_BUCKETS - 1];
+    struct GDialCallStats
+    {
+        uint64_t calls = 0;
+        uint64_t errors = 0;
+        uint64_t totalMicros = 0;
+        uint64_t maxMicros = 0;
+        uint64_t histogram[GDIAL_LATENCY_BUCKETS] = {};
+    };
+    static const char* getGDialOperationName(GDialOperation operation);
+    bool getGDialCallStats(GDialOperation operation, GDialCallStats& stats);
+
     int setManufacturerName( string manufacturer);
     string getManufacturerName(void);
     int setModelName( string model);
@@ -97,6 +227,8 @@ public:
      *Call back function for rtConnection
      */
     int isGDialStarted();
+    // Interface gdial was started on (its -I argument), empty while gdial is not running
+    std::string getGDialInterface();
 
     void setService(XCastNotifier * service){
         m_observer = service;
@@ -105,10 +237,74 @@ private:
     //Internal methods
     XCastNotifier * m_observer;
 
+    // XDial RFC settings consumed by initialize()
+    struct RFCInputs
+    {
+        bool isXDialEnabled = true;
+        bool isFriendlyNameEnabled = true;
+        bool isWolWakeEnableEnabled = true;
+        bool hasAppList = false;
+        std::string appList;
+    };
+    static RFCInputs getRFCInputs(void);
+    // Last RFC values, served to every (re)initialize; refreshed in the background
+    bool getCachedRFCInputs(RFCInputs& inputs);
+    RFCInputs fetchRFCInputs(void);
+    void runRFCRefresh(void);
+    void stopRFCRefresh(void);
+    // Returns whether a value gdial is started with changed
+    bool applyRFCInputs(const RFCInputs& previous, const RFCInputs& current);
+    RFCInputs m_rfcInputs;
+    bool m_rfcInputsValid = false;
+    bool m_rfcRefreshStop = false;
+    RFCChangeCallback m_rfcChangeCallback;
+
+    void runLivenessProbe(void);
+    void stopLivenessProbe(void);
+    void requestLivenessProbe(void);
+    // Caller holds m_gdialMutex, after a gdial instance was created
+    void onGDialConnected(void);
+    LivenessStats m_livenessStats;
+    GDialLostCallback m_gdialLostCallback;
+    std::chrono::steady_clock::time_point m_lastAliveTime;
+    std::chrono::steady_clock::time_point m_lostTime;
+    bool m_livenessSuspect = false;
+    bool m_livenessRecoveryPending = false;
+    bool m_livenessProbeRequested = false;
+    bool m_livenessStop = false;
+    std::thread m_livenessThread;
+    std::mutex m_livenessMutex;
+    std::condition_variable m_livenessWake;
+    // The probe's getProtocolVersion runs here so the prober can stop waiting; one call at a time
+    std::thread m_probeCallThread;
+    std::mutex m_probeCallMutex;
+    std::condition_variable m_probeCallDone;
+    bool m_probeCallPending = false;
+    bool m_probeCallRunning = false;
+    std::string m_probeCallVersion;
+    void joinProbeCall(void);
+    std::thread m_rfcRefreshThread;
+    std::mutex m_rfcMutex;
+    std::condition_variable m_rfcRefreshWake;
+    // gdial is only created if no cancellation happened since epoch was taken
+    bool initialize(WPEFramework::PluginHost::IShell* pluginService, const std::string& gdial_interface_name, const std::string& interfaceType, bool networkStandbyMode, uint64_t epoch);
+
     void getWiFiInterface(std::string& WiFiInterfaceName);
     void getGDialInterfaceName(std::string& interfaceName);
-    std::string getReceiverID(WPEFramework::PluginHost::IShell* pluginService);
+    // Reads the id sources (and DeviceInfo as the last resort) and caches the result under stamp
+    std::string resolveReceiverID(WPEFramework::PluginHost::IShell* pluginService, const std::string& cacheFileName, const std::string& stamp);
+    // Identity cache in the plugin's persistent path, valid while the content stamp of the id sources is unchanged
+    std::string getIdentityCacheFile(WPEFramework::PluginHost::IShell* pluginService);
+    std::string getIdentitySourcesStamp(void);
+    bool readIdentityCache(const std::string& cacheFileName, std::string& receiverId, std::string& source, std::string& stamp);
+    bool loadIdentityCache(const std::string& cacheFileName, const std::string& stamp, std::string& receiverId);
+    // Leaves the file alone when it already holds receiverId under stamp
+    void saveIdentityCache(const std::string& cacheFileName, const std::string& receiverId, const std::string& source, const std::string& stamp);
     bool envGetValue(const char *key, std::string &value);
+    // Reparses device.properties only when its mtime or size changed; caller holds m_devicePropertiesMutex
+    bool refreshDeviceProperties(void);
+    // Test hook: reads fileName instead of /etc/device.properties, empty restores it; drops the cached values
+    void setDevicePropertiesFile(const std::string& fileName);
     /**
      * Retrieves the device serial number from the deviceInfo plugin using on-demand acquisition.
      * @param pluginService The IShell service to query DeviceInfo plugin from
@@ -125,8 +321,84 @@ private:
      */
     std::string generateUUIDv5FromSerialNumber(const std::string& serialNumber);
 
+    // Control operations for gdial. They go through one ordered queue; a newer command replaces a
+    // queued one of the same type (for registrations, the higher generation is kept), and whichever
+    // caller holds m_gdialMutex applies the whole batch.
+    struct GDialCommand
+    {
+        enum Type
+        {
+            MODEL_NAME,
+            MANUFACTURER_NAME,
+            ACTIVATION,
+            NETWORK_STANDBY,
+            REGISTER_APPLICATIONS
+        };
+        explicit GDialCommand(Type commandType) : type(commandType) {}
+
+        Type type;
+        std::string value;  // model, manufacturer or friendly name
+        bool enable = false;
+        DynamicAppRegistryPtr appRegistry;
+    };
+    // Returns whether a gdial instance was there to apply the batch
+    bool submitCommand(GDialCommand command);
+    // Caller holds m_gdialMutex
+    void applyCommandQueue(void);
+    void applyRegisterApplications(const DynamicAppRegistryPtr& appRegistry);
+
+    std::deque<GDialCommand> m_commandQueue;
+    CommandQueueStats m_commandStats;
+    std::mutex m_commandMutex;
+
+    // Lock-free counters, updated by whichever thread made the gdial call
+    struct GDialCallCounters
+    {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<uint64_t> totalMicros{0};
+        std::atomic<uint64_t> maxMicros{0};
+        std::atomic<uint64_t> histogram[GDIAL_LATENCY_BUCKETS];
+        GDialCallCounters() { for (auto& bucket : histogram) bucket = 0; }
+    };
+    GDialCallCounters m_gdialCallCounters[GDIAL_OP_COUNT];
+    void recordGDialCall(GDialOperation operation, std::chrono::steady_clock::time_point start, bool failed);
+
+    // True when appRegistry has the same entries as the snapshot gdial acknowledged
+    bool isSameAppRegistration(const DynamicAppRegistry& appRegistry);
+
+    // Registry snapshot acknowledged by the current gdial instance, guarded by m_gdialMutex
+    DynamicAppRegistryPtr m_gdialAppRegistry;
+    // Written under m_gdialMutex, read without it
+    std::atomic<uint64_t> m_gdialAppsGeneration{0};
+    RegistrationStats m_registrationStats;
+    // Acked entries sorted by name for the delta check, guarded by m_gdialMutex; keeps its capacity between pushes
+    std::vector<const DynamicAppConfig*> m_ackedIndex;
+
+    // device.properties parsed once, shared by every envGetValue lookup
+    struct DeviceProperties
+    {
+        std::unordered_map<std::string, std::string> values;
+        time_t mtime = 0;
+        off_t size = -1;  // -1 until the file was read successfully
+        std::string file;  // empty for COMMON_DEVICE_PROPERTIES_FILE
+    } m_deviceProperties;
+    std::mutex m_devicePropertiesMutex;
+
     // Class level contracts
     // Singleton instance
     static XCastManager * _instance;
-    std::recursive_mutex m_mutexSync;
+    // Serializes every call into gdial and the gdial instance lifetime. Cached device
+    // metadata lives in a separately published snapshot and is read without it.
+    std::mutex m_gdialMutex;
+    // Serializes initialize() input gathering without holding m_gdialMutex
+    std::mutex m_initializeMutex;
+    // initializeAsync worker; the thread object and pending flag are guarded by m_initializeStateMutex
+    std::thread m_initializeThread;
+    bool m_initializePending = false;
+    std::mutex m_initializeStateMutex;
+    std::condition_variable m_initializeDone;
+    // Bumped on cancellation; held while a completion callback runs
+    std::atomic<uint64_t> m_initializeEpoch{0};
+    std::mutex m_initializeCallbackMutex;
 };